@@ -0,0 +1,29 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mac_mph.h"
+#include "mac_table_internal.h"
+
+int mac_mph_find(const mac_mph_t *mph, const uint8_t *mac)
+{
+    if (!mph || !mac || mph->key_count == 0) {
+        return -1;
+    }
+
+    uint64_t hash = mac_mph_hash(mac, mph->seed);
+    uint32_t displacement = mph->displacements[(uint32_t)(hash >> 32) % mph->bucket_count];
+    size_t slot = mac_mph_slot(hash, displacement, mph->key_count);
+
+    // Every input maps to some slot; only the stored key tells members apart
+    return mac_key_equal(mph->keys[slot], mac) ? (int)slot : -1;
+}
+
+mac_entry_result_t mac_mph_exists(const mac_mph_t *mph, const uint8_t *mac)
+{
+    return mac_mph_find(mph, mac) >= 0 ? MAC_TABLE_OK : MAC_TABLE_NOT_FOUND;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file mac_mph.h
+ * @brief Constant allowlists stored as minimal perfect hash tables.
+ *
+ * `tools/mac_mph_gen.c` turns a list of MAC addresses into C source holding a
+ * `const mac_mph_t` and its arrays, which the linker places in flash/rodata.
+ * A membership test is then one hash, one displacement read and one compare,
+ * with no RAM and no initialization.
+ *
+ * @copyright
+ * Copyright (c) 2025 Stanley Osagie Ramos
+ *
+ * @license
+ * MIT License (see mac_table.h)
+ */
+
+#ifndef MAC_MPH_H
+#define MAC_MPH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mac_mph_hash.h"
+#include "mac_table.h"
+
+/**
+ * @brief A generated minimal perfect hash table (hash-and-displace).
+ *
+ * Every field is filled by the generator; do not build one by hand.
+ */
+typedef struct {
+  uint32_t seed;                 /**< Hash seed found by the generator */
+  size_t key_count;              /**< Number of MACs (and slots) */
+  size_t bucket_count;           /**< Number of displacement buckets */
+  const uint32_t *displacements; /**< Displacement pair per bucket */
+  const uint8_t (*keys)[MAC_ADDR_LEN]; /**< MAC stored at each slot */
+} mac_mph_t;
+
+/**
+ * @brief Position of a MAC in a generated table.
+ *
+ * Positions are dense (0 to `key_count - 1`), so they can index constant
+ * per-device arrays emitted in the same order as `keys`.
+ *
+ * @param mph Generated table.
+ * @param mac MAC address to look up.
+ * @return The slot index, or -1 if `mac` is not in the table.
+ */
+int mac_mph_find(const mac_mph_t *mph, const uint8_t *mac);
+
+/**
+ * @brief Membership test against a generated table.
+ *
+ * @param mph Generated table.
+ * @param mac MAC address to look up.
+ * @return `MAC_TABLE_OK` if `mac` is listed, `MAC_TABLE_NOT_FOUND` otherwise.
+ */
+mac_entry_result_t mac_mph_exists(const mac_mph_t *mph, const uint8_t *mac);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MAC_MPH_H
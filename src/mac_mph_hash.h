@@ -0,0 +1,59 @@
+/**
+ * @file mac_mph_hash.h
+ * @brief Hash shared by the minimal-perfect-hash generator (host) and the
+ * runtime lookup (device). Dependency free so both sides compile it
+ * identically.
+ */
+
+#ifndef MAC_MPH_HASH_H
+#define MAC_MPH_HASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Must match the firmware build (see mac_table.h) */
+#ifndef MAC_ADDR_LEN
+#define MAC_ADDR_LEN 6
+#endif
+
+/**
+ * @brief Seeded 64-bit hash of a `MAC_ADDR_LEN`-byte key (FNV-1a with a
+ * murmur3 finalizer).
+ */
+static inline uint64_t mac_mph_hash(const uint8_t *mac, uint32_t seed) {
+  uint64_t hash = 0xCBF29CE484222325ull ^ seed;
+  for (size_t i = 0; i < MAC_ADDR_LEN; i++) {
+    hash ^= mac[i];
+    hash *= 0x100000001B3ull;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/**
+ * @brief Slot of a MAC given its hash and its bucket's displacement pair.
+ *
+ * `displacement` packs d0 in the high 16 bits and d1 in the low 16 bits; the
+ * slot is `(f1 + d0 * f2 + d1) mod key_count`.
+ */
+static inline size_t mac_mph_slot(uint64_t hash, uint32_t displacement,
+                                  size_t key_count) {
+  uint64_t f1 = (uint32_t)hash % key_count;
+  uint64_t f2 = (uint32_t)(hash >> 16) % key_count;
+  return (size_t)((f1 + (displacement >> 16) * f2 + (displacement & 0xFFFF)) %
+                  key_count);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MAC_MPH_HASH_H
@@ -0,0 +1,247 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include "mac_rule_table.h"
+#include "mac_table_internal.h"
+
+#define MAC_RULE_SEED 0x61C88647u
+
+typedef struct {
+    uint8_t mac[MAC_ADDR_LEN];  // Rule address, pre-masked
+    uint8_t mask[MAC_ADDR_LEN]; // Bits that must match
+    uint8_t priority;           // Higher wins
+    uint8_t action;             // Returned on match
+} mac_rule_t;
+
+// Rules sharing one mask: an open-addressing set of masked addresses
+typedef struct {
+    uint8_t mask[MAC_ADDR_LEN]; // Common mask
+    uint8_t max_priority;       // Best priority in the group, for early exit
+    uint16_t *slots;            // Rule index + 1 per bucket (0 = empty)
+    size_t slot_mask;           // Bucket count - 1 (power of two)
+} mac_rule_group_t;
+
+struct mac_rule_table_t {
+    mac_rule_t *rules;        // Rules in insertion order
+    size_t rule_count;        // Number of rules
+    size_t max_rules;         // Capacity of `rules`
+    mac_rule_group_t *groups; // Compiled groups, highest priority first
+    size_t group_count;       // Number of compiled groups
+    bool compiled;            // Groups reflect every rule
+};
+
+static inline void mac_rule_apply_mask(const uint8_t *mac, const uint8_t *mask, uint8_t *out)
+{
+    for (size_t i = 0; i < MAC_ADDR_LEN; i++) {
+        out[i] = mac[i] & mask[i];
+    }
+}
+
+// Rule `a` beats rule `b`: higher priority, then earlier insertion
+static inline bool mac_rule_beats(const mac_rule_table_t *rules, size_t a, size_t b)
+{
+    return rules->rules[a].priority > rules->rules[b].priority ||
+           (rules->rules[a].priority == rules->rules[b].priority && a < b);
+}
+
+static void mac_rule_table_release_groups(mac_rule_table_t *rules)
+{
+    for (size_t g = 0; g < rules->group_count; g++) {
+        free(rules->groups[g].slots);
+    }
+    free(rules->groups);
+    rules->groups = NULL;
+    rules->group_count = 0;
+    rules->compiled = false;
+}
+
+mac_rule_table_t *mac_rule_table_create(size_t max_rules)
+{
+    if (max_rules == 0 || max_rules > UINT16_MAX) {
+        return NULL;
+    }
+
+    mac_rule_table_t *rules = (mac_rule_table_t *)calloc(1, sizeof(mac_rule_table_t));
+    if (!rules) {
+        return NULL;
+    }
+    rules->rules = (mac_rule_t *)calloc(max_rules, sizeof(mac_rule_t));
+    if (!rules->rules) {
+        free(rules);
+        return NULL;
+    }
+    rules->max_rules = max_rules;
+    rules->compiled = true; // Nothing to compile yet
+    return rules;
+}
+
+void mac_rule_table_free(mac_rule_table_t *rules)
+{
+    if (!rules) {
+        return;
+    }
+    mac_rule_table_release_groups(rules);
+    free(rules->rules);
+    free(rules);
+}
+
+bool mac_rule_table_add(mac_rule_table_t *rules, const uint8_t *mac, const uint8_t *mask, uint8_t priority,
+                        uint8_t action)
+{
+    if (!rules || !mac || !mask || rules->rule_count >= rules->max_rules) {
+        return false;
+    }
+
+    mac_rule_t *rule = &rules->rules[rules->rule_count++];
+    mac_rule_apply_mask(mac, mask, rule->mac);
+    memcpy(rule->mask, mask, MAC_ADDR_LEN);
+    rule->priority = priority;
+    rule->action = action;
+    rules->compiled = false;
+    return true;
+}
+
+bool mac_rule_table_compile(mac_rule_table_t *rules)
+{
+    if (!rules) {
+        return false;
+    }
+    mac_rule_table_release_groups(rules);
+
+    rules->groups = (mac_rule_group_t *)calloc(rules->rule_count ? rules->rule_count : 1, sizeof(mac_rule_group_t));
+    if (!rules->groups) {
+        return false;
+    }
+
+    // One group per distinct mask
+    size_t *group_sizes = (size_t *)calloc(rules->rule_count ? rules->rule_count : 1, sizeof(size_t));
+    if (!group_sizes) {
+        mac_rule_table_release_groups(rules);
+        return false;
+    }
+    for (size_t r = 0; r < rules->rule_count; r++) {
+        const mac_rule_t *rule = &rules->rules[r];
+        size_t g;
+        for (g = 0; g < rules->group_count; g++) {
+            if (mac_key_equal(rules->groups[g].mask, rule->mask)) {
+                break;
+            }
+        }
+        if (g == rules->group_count) {
+            memcpy(rules->groups[g].mask, rule->mask, MAC_ADDR_LEN);
+            rules->group_count++;
+        }
+        if (rule->priority > rules->groups[g].max_priority) {
+            rules->groups[g].max_priority = rule->priority;
+        }
+        group_sizes[g]++;
+    }
+
+    // Keep buckets at most half full
+    for (size_t g = 0; g < rules->group_count; g++) {
+        size_t buckets = 2;
+        while (buckets < group_sizes[g] * 2) {
+            buckets <<= 1;
+        }
+        rules->groups[g].slots = (uint16_t *)calloc(buckets, sizeof(uint16_t));
+        if (!rules->groups[g].slots) {
+            free(group_sizes);
+            mac_rule_table_release_groups(rules);
+            return false;
+        }
+        rules->groups[g].slot_mask = buckets - 1;
+    }
+    free(group_sizes);
+
+    // Fill the sets; a duplicate address keeps only the winning rule
+    for (size_t r = 0; r < rules->rule_count; r++) {
+        const mac_rule_t *rule = &rules->rules[r];
+        mac_rule_group_t *group = NULL;
+        for (size_t g = 0; g < rules->group_count; g++) {
+            if (mac_key_equal(rules->groups[g].mask, rule->mask)) {
+                group = &rules->groups[g];
+                break;
+            }
+        }
+
+        size_t bucket = mac_hash32(rule->mac, MAC_RULE_SEED) & group->slot_mask;
+        while (group->slots[bucket] != 0) {
+            size_t other = group->slots[bucket] - 1;
+            if (mac_key_equal(rules->rules[other].mac, rule->mac)) {
+                break;
+            }
+            bucket = (bucket + 1) & group->slot_mask;
+        }
+        if (group->slots[bucket] == 0 || mac_rule_beats(rules, r, group->slots[bucket] - 1)) {
+            group->slots[bucket] = (uint16_t)(r + 1);
+        }
+    }
+
+    // Probe high-priority groups first so lookups can stop early
+    for (size_t i = 1; i < rules->group_count; i++) {
+        mac_rule_group_t group = rules->groups[i];
+        size_t j = i;
+        while (j > 0 && rules->groups[j - 1].max_priority < group.max_priority) {
+            rules->groups[j] = rules->groups[j - 1];
+            j--;
+        }
+        rules->groups[j] = group;
+    }
+
+    rules->compiled = true;
+    return true;
+}
+
+mac_entry_result_t mac_rule_table_match(const mac_rule_table_t *rules, const uint8_t *mac, uint8_t *action)
+{
+    if (!rules || !mac) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+
+    size_t best = SIZE_MAX;
+    uint8_t masked[MAC_ADDR_LEN];
+
+    if (!rules->compiled) {
+        for (size_t r = 0; r < rules->rule_count; r++) {
+            mac_rule_apply_mask(mac, rules->rules[r].mask, masked);
+            if (mac_key_equal(masked, rules->rules[r].mac) &&
+                (best == SIZE_MAX || mac_rule_beats(rules, r, best))) {
+                best = r;
+            }
+        }
+    } else {
+        for (size_t g = 0; g < rules->group_count; g++) {
+            const mac_rule_group_t *group = &rules->groups[g];
+            if (best != SIZE_MAX && rules->rules[best].priority > group->max_priority) {
+                break;
+            }
+
+            mac_rule_apply_mask(mac, group->mask, masked);
+            size_t bucket = mac_hash32(masked, MAC_RULE_SEED) & group->slot_mask;
+            while (group->slots[bucket] != 0) {
+                size_t r = group->slots[bucket] - 1;
+                if (mac_key_equal(rules->rules[r].mac, masked)) {
+                    if (best == SIZE_MAX || mac_rule_beats(rules, r, best)) {
+                        best = r;
+                    }
+                    break;
+                }
+                bucket = (bucket + 1) & group->slot_mask;
+            }
+        }
+    }
+
+    if (best == SIZE_MAX) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+    if (action) {
+        *action = rules->rules[best].action;
+    }
+    return MAC_TABLE_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
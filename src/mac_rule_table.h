@@ -0,0 +1,101 @@
+/**
+ * @file mac_rule_table.h
+ * @brief Masked (wildcard) MAC rules with priorities, for access control
+ * alongside the exact-match MAC table.
+ *
+ * Rules such as "allow 00:1A:2B:xx:xx:xx" or "deny any locally administered
+ * address" are grouped by mask when the rule table is compiled. Each group is
+ * a hash set of masked addresses, so a lookup costs one hash probe per
+ * distinct mask rather than a scan of every rule.
+ *
+ * @copyright
+ * Copyright (c) 2025 Stanley Osagie Ramos
+ *
+ * @license
+ * MIT License (see mac_table.h)
+ */
+
+#ifndef MAC_RULE_TABLE_H
+#define MAC_RULE_TABLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mac_table.h"
+
+/* Suggested rule actions; any 8-bit value may be used */
+#define MAC_RULE_DENY 0
+#define MAC_RULE_ALLOW 1
+
+struct mac_rule_table_t; /**< Forward declaration for the rule table */
+
+/**
+ * @brief A set of masked MAC rules and its compiled lookup structure.
+ */
+typedef struct mac_rule_table_t mac_rule_table_t;
+
+/**
+ * @brief Create an empty rule table.
+ *
+ * @param max_rules Maximum number of rules (at most 65535).
+ * @return Pointer to the rule table, or NULL on invalid size or allocation
+ * failure.
+ */
+mac_rule_table_t *mac_rule_table_create(size_t max_rules);
+
+/**
+ * @brief Free a rule table and its compiled structure.
+ *
+ * @param rules Pointer to the rule table (may be NULL).
+ */
+void mac_rule_table_free(mac_rule_table_t *rules);
+
+/**
+ * @brief Add a rule.
+ *
+ * A MAC matches when `(mac & mask) == (rule_mac & mask)`. An all-zero mask
+ * matches every address and serves as a default rule. When several rules
+ * match, the highest `priority` wins; among equal priorities the rule added
+ * first wins.
+ *
+ * Rules added after `mac_rule_table_compile()` are honoured immediately, but
+ * lookups fall back to a linear scan until the table is compiled again.
+ *
+ * @param rules Pointer to the rule table.
+ * @param mac Rule address.
+ * @param mask Bits of `mac` that must match.
+ * @param priority Rule priority, higher wins.
+ * @param action Value returned by `mac_rule_table_match()`.
+ * @return `true` on success, `false` on NULL arguments or when the table is
+ * full.
+ */
+bool mac_rule_table_add(mac_rule_table_t *rules, const uint8_t *mac,
+                        const uint8_t *mask, uint8_t priority,
+                        uint8_t action);
+
+/**
+ * @brief Build the per-mask hash sets used by `mac_rule_table_match()`.
+ *
+ * @param rules Pointer to the rule table.
+ * @return `true` on success, `false` on allocation failure (lookups keep
+ * using the linear scan).
+ */
+bool mac_rule_table_compile(mac_rule_table_t *rules);
+
+/**
+ * @brief Find the highest-priority rule matching a MAC.
+ *
+ * @param rules Pointer to the rule table.
+ * @param mac Address to classify.
+ * @param action Receives the action of the matching rule (may be NULL).
+ * @return `MAC_TABLE_OK` if a rule matched, `MAC_TABLE_NOT_FOUND` otherwise.
+ */
+mac_entry_result_t mac_rule_table_match(const mac_rule_table_t *rules,
+                                        const uint8_t *mac, uint8_t *action);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MAC_RULE_TABLE_H
@@ -2,253 +2,1482 @@
 extern "C" {
 #endif
 
-#ifdef ESP_PLATFORM
-#include <esp_crc.h>
-#endif
+#include <math.h>
+#include <stdlib.h>
 #include "mac_table.h"
+#include "mac_table_internal.h"
+
+static inline uint32_t mac_hash(const uint8_t *mac, size_t size)
+{
+    return mac_hash32(mac, 0) % size;
+}
+
+/* Independent seeds so jitter and flap history are uncorrelated with the home slot */
+#define MAC_JITTER_SEED 0x9E3779B9u
+#define MAC_FLAP_SEED 0x85EBCA6Bu
+#define MAC_FILTER_SEED 0xC2B2AE35u
+#define MAC_HLL_SEED 0x165667B1u
+
+// Spread a TTL by up to +/- ttl_jitter_percent, deterministically per MAC
+static time_t mac_table_jitter_ttl(const mac_table_t *table, const uint8_t *mac, time_t ttl)
+{
+    if (table->ttl_jitter_percent == 0 || ttl <= 1) {
+        return ttl;
+    }
+
+    time_t range = ttl * table->ttl_jitter_percent / 100;
+    if (range == 0) {
+        return ttl;
+    }
+
+    uint32_t span = (uint32_t)(2 * range + 1);
+    time_t jittered = ttl - range + (time_t)(mac_hash32(mac, MAC_JITTER_SEED) % span);
+    return jittered > 0 ? jittered : 1;
+}
+
+// Lifetime for an entry: custom duration, else the role's TTL, else the table default
+static time_t mac_table_entry_ttl(const mac_table_t *table, const mac_entry_t *entry,
+                                  const mac_insert_options_t *opts)
+{
+    time_t duration = (time_t)table->expiry_seconds;
+
+    if (opts && opts->has_custom_duration) {
+        duration = opts->custom_duration;
+    } else if ((entry->flags & MAC_ENTRY_FLAG_LOCAL_ADMIN) && table->la_ttl_seconds > 0) {
+        duration = (time_t)table->la_ttl_seconds;
+    } else {
+        for (size_t i = 0; i < table->role_ttl_count; i++) {
+            if (table->role_ttls[i].role == entry->role) {
+                duration = (time_t)table->role_ttls[i].ttl_seconds;
+                break;
+            }
+        }
+    }
+
+    // Shrink lifetimes while the table is under pressure
+    if (table->aging_level > 0) {
+        duration = duration * table->aging_levels[table->aging_level - 1].ttl_percent / 100;
+        if (duration < 1) {
+            duration = 1;
+        }
+    }
+
+    // Damped flappers are held longer so they stop cycling through expiry
+    if (entry->flags & MAC_ENTRY_FLAG_DAMPED) {
+        duration *= table->flap_config.ttl_multiplier;
+    }
+
+    if (table->ttl_jitter_percent == 0) {
+        return duration;
+    }
+    uint8_t mac[MAC_ADDR_LEN];
+    mac_table_entry_mac(table, entry, mac);
+    return mac_table_jitter_ttl(table, mac, duration);
+}
+
+/* Stored-key helpers. With MAC_TABLE_OUI_COMPRESSION an entry holds a dictionary
+ * id plus NIC bytes, so a MAC is first turned into that packed key; without it the
+ * key is the MAC itself. */
+#ifdef MAC_TABLE_OUI_COMPRESSION
+typedef uint32_t mac_key_t;
+
+static inline uint32_t mac_oui_bits(const uint8_t *mac)
+{
+    return (uint32_t)mac[0] << 16 | (uint32_t)mac[1] << 8 | mac[2];
+}
+
+static inline uint32_t mac_nic_bits(const uint8_t *mac)
+{
+    return (uint32_t)mac[3] << 16 | (uint32_t)mac[4] << 8 | mac[5];
+}
+
+// Home bucket of an OUI in the dictionary index
+static inline size_t mac_oui_bucket(uint32_t oui)
+{
+    return ((oui * 0x9E3779B1u) >> 16) % MAC_TABLE_OUI_INDEX_SIZE;
+}
+
+// Index bucket holding an OUI, or the empty bucket where it would go
+static size_t mac_oui_find_bucket(const mac_oui_dict_t *dict, uint32_t oui)
+{
+    size_t bucket = mac_oui_bucket(oui);
+    while (dict->index[bucket] != 0 && dict->oui[dict->index[bucket] - 1] != oui) {
+        bucket = (bucket + 1) % MAC_TABLE_OUI_INDEX_SIZE;
+    }
+    return bucket;
+}
+
+// Unlink an unused id from the index, shifting later probes back over the hole
+static void mac_oui_index_remove(mac_oui_dict_t *dict, size_t id)
+{
+    size_t hole = mac_oui_find_bucket(dict, dict->oui[id]);
+    size_t next = hole;
+    for (;;) {
+        next = (next + 1) % MAC_TABLE_OUI_INDEX_SIZE;
+        if (dict->index[next] == 0) {
+            break;
+        }
+        // An entry moves back unless its home bucket lies cyclically in (hole, next]
+        size_t home = mac_oui_bucket(dict->oui[dict->index[next] - 1]);
+        bool stays = (hole < next) ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            dict->index[hole] = dict->index[next];
+            hole = next;
+        }
+    }
+    dict->index[hole] = 0;
+}
+
+// Packed key of a MAC; false if its OUI is not in use, so it cannot be stored
+static inline bool mac_table_lookup_key(const mac_table_t *table, const uint8_t *mac, mac_key_t *key)
+{
+    const mac_oui_dict_t *dict = table->oui_dict;
+    uint16_t id = dict->index[mac_oui_find_bucket(dict, mac_oui_bits(mac))];
+    if (id == 0) {
+        return false;
+    }
+    *key = (uint32_t)(id - 1) << 24 | mac_nic_bits(mac);
+    return true;
+}
+
+static inline bool mac_entry_has_key(const mac_entry_t *entry, mac_key_t key)
+{
+    return entry->key == key;
+}
+
+// Store a MAC in a slot, taking a dictionary reference; false if the dictionary is full
+static bool mac_table_store_key(mac_table_t *table, mac_entry_t *entry, const uint8_t *mac)
+{
+    mac_oui_dict_t *dict = table->oui_dict;
+    uint32_t oui = mac_oui_bits(mac);
+    size_t bucket = mac_oui_find_bucket(dict, oui);
+    size_t id;
+    if (dict->index[bucket] != 0) {
+        id = dict->index[bucket] - 1;
+    } else {
+        // A new vendor is rare, so a scan for a free id is fine here
+        for (id = 0; id < MAC_TABLE_OUI_DICT_SIZE && dict->refs[id] > 0; id++) {
+        }
+        if (id == MAC_TABLE_OUI_DICT_SIZE) {
+            return false;
+        }
+        dict->oui[id] = oui;
+        dict->index[bucket] = (uint16_t)(id + 1);
+    }
+
+    dict->refs[id]++;
+    entry->key = (uint32_t)id << 24 | mac_nic_bits(mac);
+    return true;
+}
+
+static void mac_table_drop_key(mac_table_t *table, const mac_entry_t *entry)
+{
+    mac_oui_dict_t *dict = table->oui_dict;
+    size_t id = entry->key >> 24;
+    if (--dict->refs[id] == 0) {
+        mac_oui_index_remove(dict, id);
+    }
+}
+#else
+typedef const uint8_t *mac_key_t;
+
+static inline bool mac_table_lookup_key(const mac_table_t *table, const uint8_t *mac, mac_key_t *key)
+{
+    (void)table;
+    *key = mac;
+    return true;
+}
+
+static inline bool mac_entry_has_key(const mac_entry_t *entry, mac_key_t key)
+{
+    return mac_key_equal(entry->mac, key);
+}
+
+static inline bool mac_table_store_key(mac_table_t *table, mac_entry_t *entry, const uint8_t *mac)
+{
+    (void)table;
+    memcpy(entry->mac, mac, MAC_ADDR_LEN);
+    return true;
+}
+
+static inline void mac_table_drop_key(mac_table_t *table, const mac_entry_t *entry)
+{
+    (void)table;
+    (void)entry;
+}
+#endif
+
+void mac_table_entry_mac(const mac_table_t *table, const mac_entry_t *entry, uint8_t *mac)
+{
+#ifdef MAC_TABLE_OUI_COMPRESSION
+    uint32_t oui = table->oui_dict->oui[entry->key >> 24];
+    mac[0] = (uint8_t)(oui >> 16);
+    mac[1] = (uint8_t)(oui >> 8);
+    mac[2] = (uint8_t)oui;
+    mac[3] = (uint8_t)(entry->key >> 16);
+    mac[4] = (uint8_t)(entry->key >> 8);
+    mac[5] = (uint8_t)entry->key;
+#else
+    (void)table;
+    memcpy(mac, entry->mac, MAC_ADDR_LEN);
+#endif
+}
+
+// History record a MAC maps to (direct-mapped)
+static mac_flap_record_t *mac_table_flap_record(const mac_table_t *table, const uint8_t *mac)
+{
+    return &table->flap_records[mac_hash32(mac, MAC_FLAP_SEED) % table->flap_record_count];
+}
+
+// Penalty after exponential decay since the record was last updated
+static uint32_t mac_table_flap_decayed(const mac_table_t *table, const mac_flap_record_t *record, time_t now)
+{
+    // A clock stepped backwards decays nothing
+    time_t elapsed = now - record->updated;
+    if (elapsed < 0) {
+        elapsed = 0;
+    }
+    time_t half_lives = elapsed / table->flap_config.half_life_seconds;
+    return half_lives >= 16 ? 0 : record->penalty >> half_lives;
+}
+
+// Remember an expired MAC so that a quick re-insert counts as a flap
+static void mac_table_flap_note_expiry(mac_table_t *table, const uint8_t *mac, time_t now)
+{
+    mac_flap_record_t *record = mac_table_flap_record(table, mac);
+    uint32_t penalty = mac_table_flap_decayed(table, record, now);
+
+    if (!mac_key_equal(record->mac, mac)) {
+        // Do not let a one-off expiry displace a MAC that is still flapping
+        if (penalty >= table->flap_config.flap_penalty) {
+            return;
+        }
+        memcpy(record->mac, mac, MAC_ADDR_LEN);
+        penalty = 0;
+    }
+
+    record->penalty = penalty;
+    record->updated = now;
+    record->expired = true;
+}
+
+// Charge a re-insert of a recently expired MAC; true if it is now damped
+static bool mac_table_flap_charge(mac_table_t *table, const uint8_t *mac, time_t now)
+{
+    mac_flap_record_t *record = mac_table_flap_record(table, mac);
+    if (!record->expired || !mac_key_equal(record->mac, mac)) {
+        return false;
+    }
+
+    uint32_t penalty = mac_table_flap_decayed(table, record, now) + table->flap_config.flap_penalty;
+    record->penalty = penalty > UINT16_MAX ? UINT16_MAX : (uint16_t)penalty;
+    record->updated = now;
+    record->expired = false;
+
+    return record->penalty >= table->flap_config.suppress_threshold;
+}
+
+bool mac_table_extend_on_access(mac_table_t *table, size_t slot, time_t lifetime, time_t now)
+{
+    mac_entry_t *entry = &table->entries[slot];
+    if (!table->sliding_expiry || entry->last_access == 0) {
+        return false;
+    }
+
+    // Each hit is credited once; the next extension needs a fresh one
+    time_t deadline = entry->last_access + lifetime;
+    entry->last_access = 0;
+    if (deadline <= now || deadline <= entry->timeout_duration) {
+        return false;
+    }
+
+    entry->timeout_duration = deadline;
+    if (entry->flags & MAC_ENTRY_FLAG_STALE) {
+        entry->flags &= ~MAC_ENTRY_FLAG_STALE;
+        table->stats->stale_entries--;
+    }
+    return true;
+}
+
+// TTL percent in force at a given aging level (0 = no pressure)
+static uint32_t mac_table_level_ttl_percent(const mac_table_t *table, size_t level)
+{
+    return level > 0 ? table->aging_levels[level - 1].ttl_percent : 100;
+}
+
+// Edge-triggered occupancy notifications with hysteresis
+static void mac_table_check_watermarks(mac_table_t *table, size_t occupancy, const uint8_t *mac)
+{
+    if (table->high_watermark_percent == 0) {
+        return;
+    }
+
+    if (!table->above_high_watermark && occupancy >= table->high_watermark_percent) {
+        table->above_high_watermark = true;
+        if (table->on_event) {
+            table->on_event(-1, mac, MAC_TABLE_HIGH_WATERMARK);
+        }
+    } else if (table->above_high_watermark && occupancy <= table->low_watermark_percent) {
+        table->above_high_watermark = false;
+        if (table->on_event) {
+            table->on_event(-1, mac, MAC_TABLE_LOW_WATERMARK);
+        }
+    }
+}
+
+// Move to the aging level matching the current occupancy
+static void mac_table_apply_aging_level(mac_table_t *table, size_t occupancy)
+{
+    if (table->aging_level_count == 0) {
+        return;
+    }
+
+    size_t level = 0;
+    while (level < table->aging_level_count &&
+           occupancy >= table->aging_levels[level].occupancy_percent) {
+        level++;
+    }
+
+    if (level == table->aging_level) {
+        return;
+    }
+
+    // Entering a higher level also shortens what is already in the table, so
+    // idle entries are shed before inserts start failing. Dropping back only
+    // affects future inserts and refreshes.
+    if (level > table->aging_level && table->expiry_manager) {
+        uint32_t old_percent = mac_table_level_ttl_percent(table, table->aging_level);
+        uint32_t new_percent = mac_table_level_ttl_percent(table, level);
+        table->aging_level = level;
+        if (new_percent < old_percent) {
+            expiry_manager_scale_remaining(table->expiry_manager, new_percent, old_percent);
+        }
+        return;
+    }
+
+    table->aging_level = level;
+}
+
+void mac_table_update_pressure(mac_table_t *table, const uint8_t *mac)
+{
+    size_t occupancy = table->stats->active_entries * 100 / table->size;
+
+    mac_table_check_watermarks(table, occupancy, mac);
+    mac_table_apply_aging_level(table, occupancy);
+}
+
+// Refill the new-entry bucket; false if no token is left for an insert
+static bool mac_table_admit_insert(mac_table_t *table, time_t now)
+{
+    const mac_table_admission_config_t *cfg = &table->admission;
+    if (cfg->inserts_per_second == 0) {
+        return true;
+    }
+
+    if (now > table->admission_refilled) {
+        uint64_t tokens = table->admission_tokens + (uint64_t)(now - table->admission_refilled) * cfg->inserts_per_second;
+        table->admission_tokens = tokens > cfg->insert_burst ? cfg->insert_burst : (uint32_t)tokens;
+        table->admission_refilled = now;
+    }
+
+    return table->admission_tokens > 0;
+}
+
+// Spend a token once an insert is certain to take a slot
+static inline void mac_table_admission_charge(mac_table_t *table)
+{
+    if (table->admission.inserts_per_second > 0) {
+        table->admission_tokens--;
+    }
+}
+
+// Per-MAC limit: drop plain refreshes that would barely move the deadline.
+// Refreshes that change the role or TTL, or revive a stale entry, are always applied.
+static bool mac_table_refresh_limited(const mac_table_t *table, const mac_entry_t *entry,
+                                      const mac_insert_options_t *opts, time_t now)
+{
+    if (table->admission.min_refresh_seconds == 0) {
+        return false;
+    }
+    if (opts && (opts->has_custom_duration || (opts->has_role && opts->role != entry->role))) {
+        return false;
+    }
+    if (entry->flags & MAC_ENTRY_FLAG_STALE) {
+        return false;
+    }
+    // A plain refresh is worth applying only if it pushes the deadline out far enough
+    time_t gain = now + mac_table_entry_ttl(table, entry, opts) - entry->timeout_duration;
+    return gain < (time_t)table->admission.min_refresh_seconds;
+}
+
+// Counting Bloom filter: k probes by double hashing over a power-of-two array
+static void mac_table_filter_update(const mac_table_t *table, const uint8_t *mac, bool add)
+{
+    if (!table->filter) {
+        return;
+    }
+
+    uint32_t h1 = mac_hash32(mac, MAC_FILTER_SEED);
+    uint32_t h2 = (h1 >> 17 | h1 << 15) | 1;
+    for (uint8_t k = 0; k < table->filter_hashes; k++) {
+        uint8_t *counter = &table->filter[(h1 + k * h2) & (table->filter_size - 1)];
+        // Saturated counters stay put; they can no longer be decremented safely
+        if (*counter == UINT8_MAX) {
+            continue;
+        }
+        if (add) {
+            (*counter)++;
+        } else if (*counter > 0) {
+            (*counter)--;
+        }
+    }
+}
+
+static bool mac_table_filter_may_contain(const mac_table_t *table, const uint8_t *mac)
+{
+    if (!table->filter) {
+        return true;
+    }
+
+    uint32_t h1 = mac_hash32(mac, MAC_FILTER_SEED);
+    uint32_t h2 = (h1 >> 17 | h1 << 15) | 1;
+    for (uint8_t k = 0; k < table->filter_hashes; k++) {
+        if (table->filter[(h1 + k * h2) & (table->filter_size - 1)] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Retire distinct-estimator generations older than the window
+static void mac_table_hll_rotate(mac_table_t *table, time_t now)
+{
+    if (table->hll_generations < 2 || now - table->hll_rotated < table->hll_period) {
+        return;
+    }
+
+    time_t steps = (now - table->hll_rotated) / table->hll_period;
+    table->hll_rotated += steps * table->hll_period;
+    if (steps > table->hll_generations) {
+        steps = table->hll_generations;
+    }
+    while (steps-- > 0) {
+        table->hll_current = (table->hll_current + 1) % table->hll_generations;
+        memset(table->hll_registers + (size_t)table->hll_current * table->hll_register_count, 0,
+               table->hll_register_count);
+    }
+}
+
+// HyperLogLog update: low bits pick the register, the rest give the rank
+static void mac_table_hll_add(mac_table_t *table, const uint8_t *mac, time_t now)
+{
+    if (!table->hll_registers) {
+        return;
+    }
+    mac_table_hll_rotate(table, now);
+
+    // Rank needs well-mixed high bits; finalize the seeded hash (murmur3 fmix32)
+    uint32_t hash = mac_hash32(mac, MAC_HLL_SEED);
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    size_t index = hash & (table->hll_register_count - 1);
+    uint32_t rest = hash >> table->hll_index_bits;
+    uint8_t rank = rest ? (uint8_t)(__builtin_ctz(rest) + 1) : (uint8_t)(33 - table->hll_index_bits);
+
+    uint8_t *reg = &table->hll_registers[(size_t)table->hll_current * table->hll_register_count + index];
+    if (rank > *reg) {
+        *reg = rank;
+    }
+}
+
+// Space-Saving update: bump a monitored MAC or evict the least counted one
+static void mac_table_hh_note(const mac_table_t *table, const uint8_t *mac)
+{
+    if (!table->heavy_hitters) {
+        return;
+    }
+
+    mac_heavy_hitter_t *min = &table->heavy_hitters[0];
+    for (size_t i = 0; i < table->heavy_hitter_count; i++) {
+        mac_heavy_hitter_t *hh = &table->heavy_hitters[i];
+        if (hh->count > 0 && mac_key_equal(hh->mac, mac)) {
+            hh->count++;
+            return;
+        }
+        if (hh->count < min->count) {
+            min = hh;
+        }
+    }
+
+    // The newcomer inherits the evicted count as its possible overestimate
+    memcpy(min->mac, mac, MAC_ADDR_LEN);
+    min->error = min->count;
+    min->count++;
+}
+
+static inline void mac_table_count_hit(const mac_table_t *table, size_t slot)
+{
+    if (table->hit_counters && table->hit_counters[slot] < UINT16_MAX) {
+        table->hit_counters[slot]++;
+    }
+}
+
+// Hot cache line for a MAC: low NIC bytes, no hashing
+static inline mac_hot_cache_line_t *mac_table_cache_line(const mac_table_t *table, const uint8_t *mac)
+{
+    size_t line = (mac[MAC_ADDR_LEN - 1] ^ (mac[MAC_ADDR_LEN - 2] << 3)) & (table->hot_cache_size - 1);
+    return &table->hot_cache[line];
+}
+
+// Slot of a recently resolved MAC, or -1 if not cached or the slot changed since
+static inline int mac_table_cache_lookup(const mac_table_t *table, const uint8_t *mac)
+{
+    if (!table->hot_cache) {
+        return -1;
+    }
+
+    const mac_hot_cache_line_t *line = mac_table_cache_line(table, mac);
+    if (line->slot < 0 || !mac_key_equal(line->mac, mac)) {
+        return -1;
+    }
+
+    // The generation wraps after enough reuses of a slot, so confirm the key too
+    const mac_entry_t *entry = &table->entries[line->slot];
+    mac_key_t key;
+    if (entry->state != SLOT_OCCUPIED || entry->generation != line->generation ||
+        !mac_table_lookup_key(table, mac, &key) || !mac_entry_has_key(entry, key)) {
+        return -1;
+    }
+    return line->slot;
+}
+
+static inline void mac_table_cache_fill(const mac_table_t *table, const uint8_t *mac, size_t slot)
+{
+    if (!table->hot_cache) {
+        return;
+    }
+
+    mac_hot_cache_line_t *line = mac_table_cache_line(table, mac);
+    memcpy(line->mac, mac, MAC_ADDR_LEN);
+    line->slot = (int32_t)slot;
+    line->generation = table->entries[slot].generation;
+}
+
+// Find the slot holding a MAC, or -1
+static int mac_table_find(const mac_table_t *table, const uint8_t *mac)
+{
+    int cached = mac_table_cache_lookup(table, mac);
+    if (cached >= 0) {
+        return cached;
+    }
+
+    mac_key_t key;
+    if (!mac_table_lookup_key(table, mac, &key)) {
+        return -1;
+    }
+
+    uint32_t index = mac_hash(mac, table->size);
+
+    for (size_t i = 0; i < table->size; i++) {
+        size_t probe = (index + i) % table->size;
+        const mac_entry_t *entry = &table->entries[probe];
+
+        if (entry->state == SLOT_EMPTY) {
+            return -1;
+        }
+        if (entry->state == SLOT_OCCUPIED && mac_entry_has_key(entry, key)) {
+            mac_table_cache_fill(table, mac, probe);
+            return (int)probe;
+        }
+    }
+
+    return -1;
+}
+
+// Renew an existing entry's lifetime (reviving it if stale) and reschedule it
+static void mac_table_refresh_slot(mac_table_t *table, size_t slot, const mac_insert_options_t *opts, time_t now)
+{
+    mac_entry_t *entry = &table->entries[slot];
+
+    // A refresh without a role keeps the entry's current role
+    if (opts && opts->has_role) {
+        entry->role = opts->role;
+    }
+    if (entry->flags & MAC_ENTRY_FLAG_STALE) {
+        entry->flags &= ~MAC_ENTRY_FLAG_STALE;
+        table->stats->stale_entries--;
+    }
+    time_t ttl = mac_table_entry_ttl(table, entry, opts);
+    entry->timeout_duration = now + ttl;
+    entry->last_access = 0;
+    if (table->expiry_manager) {
+        expiry_manager_schedule(table->expiry_manager, slot, ttl);
+    }
+}
+
+bool mac_table_mark_stale(mac_table_t *table, size_t slot, time_t now)
+{
+    mac_entry_t *entry = &table->entries[slot];
+    if (table->stale_seconds == 0 || (entry->flags & MAC_ENTRY_FLAG_STALE)) {
+        return false;
+    }
+
+    entry->flags |= MAC_ENTRY_FLAG_STALE;
+    entry->timeout_duration = now + table->stale_seconds;
+    table->stats->stale_entries++;
+    return true;
+}
+
+void mac_table_release_slot(mac_table_t *table, size_t slot, mac_entry_result_t reason)
+{
+    mac_entry_t *entry = &table->entries[slot];
+    uint8_t mac[MAC_ADDR_LEN];
+    mac_table_entry_mac(table, entry, mac);
+    mac_table_drop_key(table, entry);
+    mac_table_index_remove(table, mac, slot);
+    entry->state = SLOT_TOMBSTONE;
+    entry->generation++; // Invalidates hot cache lines pointing here
+    mac_table_filter_update(table, mac, false);
+    if (table->hit_counters) {
+        table->hit_counters[slot] = 0;
+    }
+    if (entry->flags & MAC_ENTRY_FLAG_STALE) {
+        table->stats->stale_entries--;
+    }
+    if (entry->flags & MAC_ENTRY_FLAG_LOCAL_ADMIN) {
+        table->stats->la_entries--;
+    }
+    entry->flags = 0;
+
+    // Update statistics
+    if (reason == MAC_TABLE_TIMEOUT) {
+        table->stats->total_expired++;
+        if (table->flap_records) {
+            mac_table_flap_note_expiry(table, mac, time(NULL));
+        }
+    } else {
+        table->stats->total_deletes++;
+        if (table->expiry_manager) {
+            expiry_manager_delete(table->expiry_manager, slot);
+        }
+    }
+    table->stats->active_entries--;
+
+    if (table->on_event) {
+        table->on_event(slot, mac, reason);
+    }
+
+    mac_table_update_pressure(table, mac);
+}
+
+
+#define DEFAULT_ROLE 0
+
+static bool mac_table_setup(mac_table_t *table, mac_entry_t *entries, size_t size,
+                            size_t expiry_seconds, mac_table_event_callback_t on_event,
+                            mac_expiry_scheduler_t *scheduler)
+{
+    if (!table || !entries || size == 0) {
+        return false;
+    }
+
+    table->entries = entries;
+    table->size = size;
+    table->expiry_seconds = expiry_seconds;
+    table->on_event = on_event;
+    table->expiry_manager = NULL;
+    table->ttl_jitter_percent = 0;
+    table->role_ttl_count = 0;
+    table->aging_level_count = 0;
+    table->aging_level = 0;
+    table->high_watermark_percent = 0;
+    table->low_watermark_percent = 0;
+    table->above_high_watermark = false;
+    table->sliding_expiry = false;
+    table->expiry_warning_seconds = 0;
+    table->stale_seconds = 0;
+    table->flap_records = NULL;
+    table->flap_record_count = 0;
+    table->la_max_entries = 0;
+    table->la_ttl_seconds = 0;
+    memset(&table->admission, 0, sizeof(table->admission));
+    table->admission_tokens = 0;
+    table->admission_refilled = 0;
+    table->hot_cache = NULL;
+    table->hot_cache_size = 0;
+    table->filter = NULL;
+    table->filter_size = 0;
+    table->filter_hashes = 0;
+    table->approx = NULL;
+    table->hll_registers = NULL;
+    table->hll_register_count = 0;
+    table->heavy_hitters = NULL;
+    table->heavy_hitter_count = 0;
+    table->hit_counters = NULL;
+    table->index = NULL;
+    table->index_count = 0;
+
+      // Initialize stats
+      table->stats = (mac_table_stats_t *)calloc(1, sizeof(mac_table_stats_t));  // Allocate memory for stats
+      if (!table->stats) {
+          return false;
+      }
+
+    for (size_t i = 0; i < size; i++) {
+        table->entries[i].state = SLOT_EMPTY;
+        table->entries[i].timeout_duration = 0;
+        table->entries[i].last_access = 0;
+        table->entries[i].flags = 0;
+        table->entries[i].generation = 0;
+#ifdef MAC_TABLE_OUI_COMPRESSION
+        table->entries[i].key = 0;
+#else
+        memset(table->entries[i].mac, 0, MAC_ADDR_LEN);
+#endif
+    }
+
+#ifdef MAC_TABLE_OUI_COMPRESSION
+    table->oui_dict = (mac_oui_dict_t *)calloc(1, sizeof(mac_oui_dict_t));
+    table->owns_oui_dict = true;
+    if (!table->oui_dict) {
+        return false;
+    }
+#endif
+
+    table->expiry_manager = scheduler ? expiry_manager_create_shared(table, scheduler)
+                                      : expiry_manager_create(table);
+    if (!table->expiry_manager) {
+        return false;
+    }
+
+    return true;
+}
+
+bool mac_table_init(mac_table_t *table, mac_entry_t *entries, size_t size,
+                    size_t expiry_seconds, mac_table_event_callback_t on_event)
+{
+    return mac_table_setup(table, entries, size, expiry_seconds, on_event, NULL);
+}
+
+bool mac_table_init_approx(mac_table_t *table, const mac_table_approx_config_t *config,
+                           size_t expiry_seconds, mac_table_event_callback_t on_event)
+{
+    if (!table || !config || expiry_seconds == 0) {
+        return false;
+    }
+
+    // No slots and no expiry manager; every per-slot policy stays off
+    memset(table, 0, sizeof(*table));
+    table->expiry_seconds = expiry_seconds;
+    table->on_event = on_event;
+
+    table->stats = (mac_table_stats_t *)calloc(1, sizeof(mac_table_stats_t));
+    if (!table->stats) {
+        return false;
+    }
+
+    table->approx = mac_table_approx_create(config, expiry_seconds);
+    if (!table->approx) {
+        free(table->stats);
+        table->stats = NULL;
+        return false;
+    }
+    return true;
+}
+
+bool mac_table_init_shared(mac_table_t *table, mac_entry_t *entries, size_t size,
+                           size_t expiry_seconds, mac_table_event_callback_t on_event,
+                           mac_expiry_scheduler_t *scheduler)
+{
+    if (!scheduler) {
+        return false;
+    }
+    return mac_table_setup(table, entries, size, expiry_seconds, on_event, scheduler);
+}
+
+mac_entry_result_t mac_table_insert(mac_table_t *table, const uint8_t *mac) {
+    return mac_table_insert_ex(table, mac, NULL);
+}
+mac_entry_result_t mac_table_insert_ex(mac_table_t *table, const uint8_t *mac, const mac_insert_options_t *opts)
+{
+    if (!table || !mac) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+
+    // Every attempt counts, including ones rejected below
+    time_t current_time = time(NULL);
+    mac_table_hll_add(table, mac, current_time);
+    mac_table_hh_note(table, mac);
+
+    if (table->approx) {
+        return mac_table_approx_insert(table, mac);
+    }
+
+    int first_tombstone = -1;
+    int first_empty = -1;
+
+    int existing = mac_table_cache_lookup(table, mac);
+    if (existing < 0) {
+        // An unknown OUI cannot be stored yet; only look for a free slot then
+        mac_key_t key;
+        bool known = mac_table_lookup_key(table, mac, &key);
+        uint32_t index = mac_hash(mac, table->size);
+
+        for (size_t i = 0; i < table->size; i++) {
+            size_t probe = (index + i) % table->size;
+            mac_entry_t *entry = &table->entries[probe];
+
+            if (entry->state == SLOT_OCCUPIED) {
+                if (known && mac_entry_has_key(entry, key)) {
+                    existing = (int)probe;
+                    mac_table_cache_fill(table, mac, probe);
+                    break;
+                }
+            } else if (entry->state == SLOT_TOMBSTONE && first_tombstone == -1) {
+                first_tombstone = probe;
+            } else if (entry->state == SLOT_EMPTY) {
+                first_empty = probe;
+                break;
+            }
+        }
+    }
+
+    if (existing >= 0) {
+        mac_table_count_hit(table, existing);
+
+        if (mac_table_refresh_limited(table, &table->entries[existing], opts, current_time)) {
+            table->stats->total_rate_limited++;
+            return MAC_TABLE_RATE_LIMITED;
+        }
+        mac_table_refresh_slot(table, existing, opts, current_time);
+        if (table->on_event) {
+            table->on_event(existing, mac, MAC_TABLE_UPDATED);
+        }
+        return MAC_TABLE_UPDATED;
+    }
+
+    // Randomized (locally administered) MACs live in their own capped partition
+    bool local_admin = table->la_max_entries > 0 && (mac[0] & MAC_ADDR_LOCAL_ADMIN_BIT);
+    if (local_admin && table->stats->la_entries >= table->la_max_entries) {
+        table->stats->total_la_rejected++;
+        if (table->on_event) {
+            table->on_event(-1, mac, MAC_TABLE_FULL);
+        }
+        return MAC_TABLE_FULL;
+    }
+
+    // Reuse the earliest tombstone on the probe path to keep chains short
+    int slot = (first_tombstone != -1) ? first_tombstone : first_empty;
+
+    // Global limit on new entries: a spoofing flood becomes counted rejections.
+    // Inserts that fail for lack of space do not spend the budget.
+    if (slot != -1 && !mac_table_admit_insert(table, current_time)) {
+        table->stats->total_rate_limited++;
+        return MAC_TABLE_RATE_LIMITED;
+    }
+
+    if (slot != -1 && mac_table_store_key(table, &table->entries[slot], mac)) {
+        mac_entry_t *entry = &table->entries[slot];
+        slot_state_t vacant_state = entry->state;
+        entry->role = (opts && opts->has_role) ? opts->role : DEFAULT_ROLE;
+        entry->last_access = 0;
+        entry->flags = local_admin ? MAC_ENTRY_FLAG_LOCAL_ADMIN : 0;
+        if (table->flap_records && mac_table_flap_charge(table, mac, current_time)) {
+            entry->flags |= MAC_ENTRY_FLAG_DAMPED;
+        }
+        time_t ttl = mac_table_entry_ttl(table, entry, opts);
+        entry->timeout_duration = current_time + ttl;
+        entry->state = SLOT_OCCUPIED;
+
+        if (!table->expiry_manager || expiry_manager_schedule(table->expiry_manager, slot, ttl)) {
+            mac_table_admission_charge(table);
+            mac_table_cache_fill(table, mac, slot);
+            mac_table_filter_update(table, mac, true);
+            mac_table_index_add(table, mac, slot);
+
+            // Update statistics
+            table->stats->total_inserts++;
+            table->stats->active_entries++;
+            if (local_admin) {
+                table->stats->la_entries++;
+            }
+            if (entry->flags & MAC_ENTRY_FLAG_DAMPED) {
+                table->stats->total_flap_damped++;
+            }
+
+            if (table->on_event) {
+                table->on_event(slot, mac, MAC_TABLE_INSERTED);
+            }
+            mac_table_update_pressure(table, mac);
+
+            return MAC_TABLE_INSERTED;
+        }
+
+        // An entry whose deadline cannot be queued would never expire; give
+        // the slot back untouched and report the table full
+        mac_table_drop_key(table, entry);
+        entry->state = vacant_state;
+        entry->flags = 0;
+    }
+
+    if (table->on_event) {
+        table->on_event(-1, mac, MAC_TABLE_FULL);
+    }
+
+    return MAC_TABLE_FULL;
+}
+
+
+mac_entry_result_t mac_table_touch(mac_table_t *table, const uint8_t *mac)
+{
+    if (!table || !mac) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+    if (table->approx) {
+        if (mac_table_approx_exists(table, mac) != MAC_TABLE_OK) {
+            return MAC_TABLE_NOT_FOUND;
+        }
+        mac_table_hh_note(table, mac);
+        return mac_table_approx_insert(table, mac);
+    }
+
+    int slot = mac_table_find(table, mac);
+    if (slot < 0) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+    mac_table_hh_note(table, mac);
+    mac_table_count_hit(table, slot);
+
+    mac_table_refresh_slot(table, (size_t)slot, NULL, time(NULL));
+    return MAC_TABLE_UPDATED;
+}
+
+mac_entry_result_t mac_table_exists(const mac_table_t *table, const uint8_t *mac)
+{
+    if (!table || !mac) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+    if (table->approx) {
+        mac_entry_result_t result = mac_table_approx_exists(table, mac);
+        if (result == MAC_TABLE_OK) {
+            mac_table_hh_note(table, mac);
+        }
+        return result;
+    }
+
+    if (!mac_table_filter_may_contain(table, mac)) {
+        table->stats->total_filter_rejects++;
+        return MAC_TABLE_NOT_FOUND;
+    }
+
+    int slot = mac_table_find(table, mac);
+    if (slot < 0) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+
+    mac_table_hh_note(table, mac);
+    mac_table_count_hit(table, slot);
+
+    // Only stamp the slot; the deadline is pushed when it comes due
+    if (table->sliding_expiry) {
+        table->entries[slot].last_access = time(NULL);
+    }
+    return MAC_TABLE_OK;
+}
+
+mac_entry_result_t mac_table_delete(mac_table_t *table, const uint8_t *mac)
+{
+    if (!table || !mac) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+    if (table->approx) {
+        return MAC_TABLE_NOT_FOUND; // Filter bits are shared; approximate entries only age out
+    }
+
+    int slot = mac_table_find(table, mac);
+    if (slot < 0) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+
+    mac_table_release_slot(table, (size_t)slot, MAC_TABLE_DELETED);
+    return MAC_TABLE_DELETED;
+}
+
 
-static inline uint32_t mac_hash(const uint8_t *mac, size_t size)
+mac_entry_result_t mac_table_get_by_index(const mac_table_t *table, size_t index, mac_entry_t *out_entry)
 {
-#ifdef ESP_PLATFORM
-    uint32_t crc = esp_crc32_le(0, mac, MAC_ADDR_LEN);
-    return crc % size;
-#else
-    uint32_t hash = 0x811C9DC5;
-    for (size_t i = 0; i < MAC_ADDR_LEN; ++i) {
-        hash ^= mac[i];
-        hash *= 0x01000193;
+    if (!table || index >= table->size) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+
+    const mac_entry_t *entry = &table->entries[index];
+
+    if (entry->state != SLOT_OCCUPIED) {
+        return MAC_TABLE_NOT_FOUND;
     }
-    return hash % size;
+
+    if (out_entry != NULL) {
+#ifdef MAC_TABLE_OUI_COMPRESSION
+        out_entry->key = entry->key;
+#else
+        memcpy(out_entry->mac, entry->mac, MAC_ADDR_LEN);
 #endif
-}                   
+        out_entry->timeout_duration = entry->timeout_duration;
+        out_entry->state = entry->state;
+        out_entry->role = entry->role;
+        out_entry->last_access = entry->last_access;
+        out_entry->flags = entry->flags;
+        out_entry->generation = entry->generation;
+    }
 
+    return MAC_TABLE_OK;
+}
 
-#define DEFAULT_ROLE 0
+void mac_table_delete_by_index(mac_table_t *table, size_t index) {
+    if (index >= table->size) return;
 
-bool mac_table_init(mac_table_t *table, mac_entry_t *entries, size_t size,
-                    size_t expiry_seconds, mac_table_event_callback_t on_event)
+    if (table->entries[index].state == SLOT_OCCUPIED) {
+        mac_table_release_slot(table, index, MAC_TABLE_DELETED);
+    }
+}
+
+
+
+bool mac_table_set_ttl_jitter(mac_table_t *table, uint8_t percent)
 {
-    if (!table || !entries || size == 0) {
+    if (!table || table->approx || percent > 100) {
         return false;
     }
+    table->ttl_jitter_percent = percent;
+    return true;
+}
 
-    table->entries = entries;
-    table->size = size;
-    table->expiry_seconds = expiry_seconds;
-    table->on_event = on_event;
-    table->expiry_manager = NULL;
-
-      // Initialize stats
-      table->stats = (mac_table_stats_t *)calloc(1, sizeof(mac_table_stats_t));  // Allocate memory for stats
-      if (!table->stats) {
-          return false;
-      }
+bool mac_table_set_role_ttl(mac_table_t *table, uint8_t role, uint32_t ttl_seconds)
+{
+    if (!table || table->approx) {
+        return false;
+    }
 
-    for (size_t i = 0; i < size; i++) {
-        table->entries[i].state = SLOT_EMPTY;
-        table->entries[i].timeout_duration = 0;
-        memset(table->entries[i].mac, 0, MAC_ADDR_LEN);
+    for (size_t i = 0; i < table->role_ttl_count; i++) {
+        if (table->role_ttls[i].role != role) {
+            continue;
+        }
+        if (ttl_seconds == 0) {
+            // Drop the override, keeping the map dense
+            table->role_ttls[i] = table->role_ttls[--table->role_ttl_count];
+        } else {
+            table->role_ttls[i].ttl_seconds = ttl_seconds;
+        }
+        return true;
     }
 
-    table->expiry_manager = expiry_manager_create(table);
-    if (!table->expiry_manager) {
+    if (ttl_seconds == 0) {
+        return true;
+    }
+    if (table->role_ttl_count >= MAC_TABLE_MAX_ROLE_TTLS) {
         return false;
     }
 
+    table->role_ttls[table->role_ttl_count].role = role;
+    table->role_ttls[table->role_ttl_count].ttl_seconds = ttl_seconds;
+    table->role_ttl_count++;
     return true;
 }
 
-mac_entry_result_t mac_table_insert(mac_table_t *table, const uint8_t *mac) {
-    return mac_table_insert_ex(table, mac, NULL);
-}
-mac_entry_result_t mac_table_insert_ex(mac_table_t *table, const uint8_t *mac, const mac_insert_options_t *opts)
+bool mac_table_set_adaptive_aging(mac_table_t *table, const mac_table_aging_level_t *levels, size_t count)
 {
-    if (!table || !mac) {
-        return MAC_TABLE_NOT_FOUND;
+    if (!table || table->approx || count > MAC_TABLE_MAX_AGING_LEVELS || (count > 0 && !levels)) {
+        return false;
     }
 
-    uint32_t index = mac_hash(mac, table->size);
-    int first_tombstone = -1;
-    time_t current_time = time(NULL);
+    for (size_t i = 0; i < count; i++) {
+        if (levels[i].ttl_percent == 0 || levels[i].ttl_percent > 100) {
+            return false;
+        }
+        if (i > 0 && (levels[i].occupancy_percent <= levels[i - 1].occupancy_percent ||
+                      levels[i].ttl_percent > levels[i - 1].ttl_percent)) {
+            return false;
+        }
+    }
 
-    time_t timeout = (opts && opts->has_custom_duration)
-        ? current_time + opts->custom_duration
-        : current_time + table->expiry_seconds;
+    memcpy(table->aging_levels, levels, count * sizeof(mac_table_aging_level_t));
+    table->aging_level_count = count;
+    table->aging_level = 0;
 
-    uint8_t role = (opts && opts->has_role) ? opts->role : DEFAULT_ROLE;
+    // Watermark events need the MAC that crossed them, so only aging is re-evaluated here
+    mac_table_apply_aging_level(table, table->stats->active_entries * 100 / table->size);
+    return true;
+}
 
-    for (size_t i = 0; i < table->size; i++) {
-        size_t probe = (index + i) % table->size;
-        mac_entry_t *entry = &table->entries[probe];
-
-        if (entry->state == SLOT_OCCUPIED) {
-            if (memcmp(entry->mac, mac, MAC_ADDR_LEN) == 0) {
-                entry->timeout_duration = timeout;
-                entry->role = role;
-                if (table->expiry_manager) {
-                    expiry_manager_add_or_update(table->expiry_manager, probe);
-                }
-                if (table->on_event) {
-                    table->on_event(probe, mac, MAC_TABLE_UPDATED);
-                }
-                return MAC_TABLE_UPDATED;
-            }
-        } else if (entry->state == SLOT_TOMBSTONE && first_tombstone == -1) {
-            first_tombstone = probe;
-        } else if (entry->state == SLOT_EMPTY) {
-            memcpy(entry->mac, mac, MAC_ADDR_LEN);
-            entry->state = SLOT_OCCUPIED;
-            entry->timeout_duration = timeout;
-            entry->role = role;
+bool mac_table_set_watermarks(mac_table_t *table, uint8_t high_percent, uint8_t low_percent)
+{
+    if (!table || table->approx || high_percent > 100 || (high_percent > 0 && low_percent >= high_percent)) {
+        return false;
+    }
 
-            // Update statistics
-            table->stats->total_inserts++;
-            table->stats->active_entries++;
+    table->high_watermark_percent = high_percent;
+    table->low_watermark_percent = low_percent;
+    table->above_high_watermark = false;
+    return true;
+}
 
-            if (table->expiry_manager) {
-                expiry_manager_add_or_update(table->expiry_manager, probe);
-            }
-            if (table->on_event) {
-                table->on_event(probe, mac, MAC_TABLE_INSERTED);
-            }
+bool mac_table_set_sliding_expiry(mac_table_t *table, bool enable)
+{
+    if (!table || table->approx) {
+        return false;
+    }
+    table->sliding_expiry = enable;
+    return true;
+}
 
+bool mac_table_set_expiry_warning(mac_table_t *table, uint32_t grace_seconds)
+{
+    if (!table || table->approx) {
+        return false;
+    }
+    table->expiry_warning_seconds = grace_seconds;
+    return true;
+}
 
-            return MAC_TABLE_INSERTED;
-        }
+bool mac_table_set_stale_timeout(mac_table_t *table, uint32_t stale_seconds)
+{
+    if (!table || table->approx) {
+        return false;
     }
+    table->stale_seconds = stale_seconds;
+    return true;
+}
 
-    if (first_tombstone != -1) {
-        mac_entry_t *entry = &table->entries[first_tombstone];
-        memcpy(entry->mac, mac, MAC_ADDR_LEN);
-        entry->timeout_duration = timeout;
-        entry->role = role;
-        entry->state = SLOT_OCCUPIED;
+bool mac_table_enable_flap_damping(mac_table_t *table, mac_flap_record_t *records, size_t count,
+                                   const mac_table_flap_config_t *config)
+{
+    if (!table || table->approx) {
+        return false;
+    }
+    if (!records || count == 0) {
+        table->flap_records = NULL;
+        table->flap_record_count = 0;
+        return true;
+    }
+    if (!config || config->half_life_seconds == 0 || config->flap_penalty == 0 ||
+        config->ttl_multiplier == 0) {
+        return false;
+    }
 
-                // Update statistics
-                table->stats->total_inserts++;
-                table->stats->active_entries++;
-        
-        if (table->expiry_manager) {
-            expiry_manager_add_or_update(table->expiry_manager, first_tombstone);
-        }
-        if (table->on_event) {
-            table->on_event(first_tombstone, mac, MAC_TABLE_INSERTED);
-        }
+    memset(records, 0, count * sizeof(mac_flap_record_t));
+    table->flap_config = *config;
+    table->flap_records = records;
+    table->flap_record_count = count;
+    return true;
+}
 
-        return MAC_TABLE_INSERTED;
+bool mac_table_set_la_partition(mac_table_t *table, size_t max_entries, uint32_t ttl_seconds)
+{
+    if (!table || table->approx || max_entries > table->size) {
+        return false;
     }
+    if (max_entries > 0 && MAC_ADDR_LEN != 6) {
+        return false; // Only MAC-48 keys carry the U/L bit in the first byte
+    }
+    table->la_max_entries = max_entries;
+    table->la_ttl_seconds = ttl_seconds;
+    return true;
+}
 
-    if (table->on_event) {
-        table->on_event(-1, mac, MAC_TABLE_FULL);
+bool mac_table_set_admission_control(mac_table_t *table, const mac_table_admission_config_t *config)
+{
+    if (!table || table->approx) {
+        return false;
+    }
+    if (!config) {
+        memset(&table->admission, 0, sizeof(table->admission));
+        return true;
+    }
+    if (config->inserts_per_second > 0 && config->insert_burst == 0) {
+        return false;
     }
 
-    return MAC_TABLE_FULL;
+    table->admission = *config;
+    table->admission_tokens = config->insert_burst;
+    table->admission_refilled = time(NULL);
+    return true;
 }
 
+bool mac_table_enable_hot_cache(mac_table_t *table, mac_hot_cache_line_t *lines, size_t count)
+{
+    if (!table || table->approx) {
+        return false;
+    }
+    if (!lines || count == 0) {
+        table->hot_cache = NULL;
+        table->hot_cache_size = 0;
+        return true;
+    }
+    if ((count & (count - 1)) != 0) {
+        return false; // Must be a power of two
+    }
 
-mac_entry_result_t mac_table_exists(const mac_table_t *table, const uint8_t *mac)
+    for (size_t i = 0; i < count; i++) {
+        lines[i].slot = -1;
+    }
+    table->hot_cache = lines;
+    table->hot_cache_size = count;
+    return true;
+}
+
+bool mac_table_enable_filter(mac_table_t *table, uint8_t *counters, size_t count, uint8_t hashes)
 {
-    if (!table || !mac) {
-        return MAC_TABLE_NOT_FOUND;
+    if (!table || table->approx) {
+        return false;
+    }
+    if (!counters || count == 0) {
+        table->filter = NULL;
+        table->filter_size = 0;
+        table->filter_hashes = 0;
+        return true;
+    }
+    if ((count & (count - 1)) != 0 || hashes == 0) {
+        return false;
     }
 
-    uint32_t index = mac_hash(mac, table->size);
+    memset(counters, 0, count);
+    table->filter = counters;
+    table->filter_size = count;
+    table->filter_hashes = hashes;
 
+    // Seed with whatever is already in the table
     for (size_t i = 0; i < table->size; i++) {
-        size_t probe = (index + i) % table->size;
-        const mac_entry_t *entry = &table->entries[probe];
-
-        if (entry->state == SLOT_EMPTY) {
-            return MAC_TABLE_NOT_FOUND;
+        if (table->entries[i].state == SLOT_OCCUPIED) {
+            uint8_t mac[MAC_ADDR_LEN];
+            mac_table_entry_mac(table, &table->entries[i], mac);
+            mac_table_filter_update(table, mac, true);
         }
+    }
+    return true;
+}
 
-        if (entry->state == SLOT_OCCUPIED && memcmp(entry->mac, mac, MAC_ADDR_LEN) == 0) {
-            return MAC_TABLE_OK;
-        }
+bool mac_table_enable_distinct_estimator(mac_table_t *table, uint8_t *registers, size_t count,
+                                         uint8_t generations, uint32_t window_seconds)
+{
+    if (!table) {
+        return false;
+    }
+    if (!registers || count == 0) {
+        table->hll_registers = NULL;
+        table->hll_register_count = 0;
+        return true;
+    }
+    if (count < 16 || count > 65536 || (count & (count - 1)) != 0 || generations == 0 ||
+        (generations > 1 && window_seconds == 0)) {
+        return false;
+    }
+
+    uint8_t index_bits = 0;
+    while (((size_t)1 << index_bits) < count) {
+        index_bits++;
     }
 
-    return MAC_TABLE_NOT_FOUND;
+    memset(registers, 0, count * generations);
+    table->hll_registers = registers;
+    table->hll_register_count = count;
+    table->hll_index_bits = index_bits;
+    table->hll_generations = generations;
+    table->hll_current = 0;
+    table->hll_period = generations > 1 ? (time_t)(window_seconds / (generations - 1)) : 0;
+    if (generations > 1 && table->hll_period == 0) {
+        table->hll_period = 1;
+    }
+    table->hll_rotated = time(NULL);
+    return true;
 }
 
-mac_entry_result_t mac_table_delete(mac_table_t *table, const uint8_t *mac)
+size_t mac_table_estimate_distinct(mac_table_t *table)
 {
-    if (!table || !mac) {
-        return MAC_TABLE_NOT_FOUND;
+    if (!table || !table->hll_registers) {
+        return 0;
+    }
+    mac_table_hll_rotate(table, time(NULL));
+
+    // Union of the live generations is the per-register maximum
+    size_t m = table->hll_register_count;
+    double sum = 0.0;
+    size_t zeros = 0;
+    for (size_t i = 0; i < m; i++) {
+        uint8_t reg = 0;
+        for (uint8_t g = 0; g < table->hll_generations; g++) {
+            uint8_t value = table->hll_registers[(size_t)g * m + i];
+            if (value > reg) {
+                reg = value;
+            }
+        }
+        sum += ldexp(1.0, -reg);
+        zeros += reg == 0;
     }
 
-    uint32_t index = mac_hash(mac, table->size);
+    double alpha = m == 16 ? 0.673 : m == 32 ? 0.697 : m == 64 ? 0.709 : 0.7213 / (1.0 + 1.079 / m);
+    double estimate = alpha * m * m / sum;
 
-    for (size_t i = 0; i < table->size; i++) {
-        size_t probe = (index + i) % table->size;
-        mac_entry_t *entry = &table->entries[probe];
+    // Small-range correction (linear counting) and 32-bit hash saturation
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * log((double)m / zeros);
+    } else if (estimate > 4294967296.0 / 30.0) {
+        estimate = -4294967296.0 * log(1.0 - estimate / 4294967296.0);
+    }
+    return (size_t)(estimate + 0.5);
+}
 
-        if (entry->state == SLOT_EMPTY) {
-            return MAC_TABLE_NOT_FOUND;
-        }
+bool mac_table_enable_heavy_hitters(mac_table_t *table, mac_heavy_hitter_t *counters, size_t k)
+{
+    if (!table) {
+        return false;
+    }
+    if (!counters || k == 0) {
+        table->heavy_hitters = NULL;
+        table->heavy_hitter_count = 0;
+        return true;
+    }
 
-        if (entry->state == SLOT_OCCUPIED && memcmp(entry->mac, mac, MAC_ADDR_LEN) == 0) {
-            entry->state = SLOT_TOMBSTONE;
+    memset(counters, 0, k * sizeof(mac_heavy_hitter_t));
+    table->heavy_hitters = counters;
+    table->heavy_hitter_count = k;
+    return true;
+}
 
-            // Update statistics
-            table->stats->total_deletes++;
-            table->stats->active_entries--;
+size_t mac_table_get_heavy_hitters(const mac_table_t *table, mac_heavy_hitter_t *out, size_t max)
+{
+    if (!table || !out || !table->heavy_hitters) {
+        return 0;
+    }
 
-            if (table->expiry_manager) {
-                expiry_manager_delete(table->expiry_manager, probe);
+    // Insertion sort by count, descending; k is small
+    size_t n = 0;
+    for (size_t i = 0; i < table->heavy_hitter_count; i++) {
+        const mac_heavy_hitter_t *hh = &table->heavy_hitters[i];
+        if (hh->count == 0) {
+            continue;
+        }
+        size_t pos = n < max ? n : max;
+        while (pos > 0 && out[pos - 1].count < hh->count) {
+            if (pos < max) {
+                out[pos] = out[pos - 1];
             }
-            if (table->on_event) {
-                table->on_event(probe, mac, MAC_TABLE_DELETED);
+            pos--;
+        }
+        if (pos < max) {
+            out[pos] = *hh;
+            if (n < max) {
+                n++;
             }
-
-            return MAC_TABLE_DELETED;
         }
     }
-
-    return MAC_TABLE_NOT_FOUND;
+    return n;
 }
 
-
-mac_entry_result_t mac_table_get_by_index(const mac_table_t *table, size_t index, mac_entry_t *out_entry)
+bool mac_table_enable_hit_counters(mac_table_t *table, uint16_t *counters)
 {
-    if (!table || index >= table->size) {
-        return MAC_TABLE_NOT_FOUND;
+    if (!table || table->approx) {
+        return false;
     }
-
-    const mac_entry_t *entry = &table->entries[index];
-
-    if (entry->state != SLOT_OCCUPIED) {
-        return MAC_TABLE_NOT_FOUND;
+    if (counters) {
+        memset(counters, 0, table->size * sizeof(uint16_t));
     }
+    table->hit_counters = counters;
+    return true;
+}
 
-    if (out_entry != NULL) {
-        memcpy(out_entry->mac, entry->mac, MAC_ADDR_LEN);
-        out_entry->timeout_duration = entry->timeout_duration;
-        out_entry->state = entry->state;
-        out_entry->role = entry->role;
+// Exchange the contents of two slots; generations stay with the slot
+static void mac_table_swap_slots(mac_table_t *table, size_t a, size_t b)
+{
+    mac_slot_generation_t generation_a = table->entries[a].generation;
+    mac_slot_generation_t generation_b = table->entries[b].generation;
+    mac_entry_t tmp = table->entries[a];
+    table->entries[a] = table->entries[b];
+    table->entries[b] = tmp;
+    table->entries[a].generation = generation_a + 1;
+    table->entries[b].generation = generation_b + 1;
+
+    uint16_t hits = table->hit_counters[a];
+    table->hit_counters[a] = table->hit_counters[b];
+    table->hit_counters[b] = hits;
+
+    uint8_t mac[MAC_ADDR_LEN];
+    if (table->entries[a].state == SLOT_OCCUPIED) {
+        mac_table_entry_mac(table, &table->entries[a], mac);
+        mac_table_index_move(table, mac, b, a);
+    }
+    if (table->entries[b].state == SLOT_OCCUPIED) {
+        mac_table_entry_mac(table, &table->entries[b], mac);
+        mac_table_index_move(table, mac, a, b);
     }
 
-    return MAC_TABLE_OK;
+    if (table->expiry_manager) {
+        expiry_manager_swap_slots(table->expiry_manager, a, b);
+    }
 }
 
-void mac_table_delete_by_index(mac_table_t *table, size_t index) {
-    if (index >= table->size) return;
+size_t mac_table_relocate_hot(mac_table_t *table)
+{
+    if (!table || !table->hit_counters || table->approx) {
+        return 0;
+    }
 
-    mac_entry_t *entry = &table->entries[index];
-    if (entry->state == SLOT_OCCUPIED) {
-        entry->state = SLOT_TOMBSTONE;
+    size_t moved = 0;
+    for (size_t slot = 0; slot < table->size; slot++) {
+        mac_entry_t *entry = &table->entries[slot];
+        if (entry->state != SLOT_OCCUPIED || table->hit_counters[slot] == 0) {
+            continue;
+        }
 
-        table->stats->total_deletes++;
-        table->stats->active_entries--;
+        // Every slot between home and here is occupied or a tombstone, so any
+        // of them is on this entry's probe path and a colder occupant there
+        // still reaches this slot from its own home.
+        uint8_t mac[MAC_ADDR_LEN];
+        mac_table_entry_mac(table, entry, mac);
+        size_t home = mac_hash(mac, table->size);
+        for (size_t probe = home; probe != slot; probe = (probe + 1) % table->size) {
+            mac_entry_t *target = &table->entries[probe];
+            if (target->state == SLOT_OCCUPIED && table->hit_counters[probe] >= table->hit_counters[slot]) {
+                continue;
+            }
 
-        if (table->on_event) {
-            table->on_event(index, entry->mac, MAC_TABLE_DELETED);
+            bool swapped = target->state == SLOT_OCCUPIED;
+            mac_table_swap_slots(table, slot, probe);
+            moved++;
+            if (table->on_event) {
+                table->on_event(probe, mac, MAC_TABLE_RELOCATED);
+                if (swapped) {
+                    mac_table_entry_mac(table, &table->entries[slot], mac);
+                    table->on_event(slot, mac, MAC_TABLE_RELOCATED);
+                }
+            }
+            break;
         }
+    }
 
-        expiry_manager_delete(table->expiry_manager, index);
+    for (size_t i = 0; i < table->size; i++) {
+        table->hit_counters[i] >>= 1;
     }
+    return moved;
 }
 
+#ifdef MAC_TABLE_OUI_COMPRESSION
+bool mac_table_share_oui_dict(mac_table_t *table, mac_oui_dict_t *dict)
+{
+    if (!table || !dict || table->stats->active_entries > 0) {
+        return false;
+    }
 
+    if (table->owns_oui_dict) {
+        free(table->oui_dict);
+    }
+    table->oui_dict = dict;
+    table->owns_oui_dict = false;
+    return true;
+}
+#endif
 
 bool mac_table_get_stats(const mac_table_t *table, mac_table_stats_t *stats){
     if (table && stats) {
@@ -264,37 +1493,23 @@ int mac_table_evict_by_role(mac_table_t *table, uint8_t role) {
     for (size_t i = 0; i < table->size; i++) {
         mac_entry_t *entry = &table->entries[i];
         if (entry->state == SLOT_OCCUPIED && entry->role == role) {
-            
-            entry->state = SLOT_TOMBSTONE;
+            mac_table_release_slot(table, i, MAC_TABLE_DELETED);
             evicted_count++;
-            table->stats->total_deletes++;
-            table->stats->active_entries--;
-
-            if (table->on_event) {
-                table->on_event(i, entry->mac, MAC_TABLE_DELETED);
-            }
-    
-            expiry_manager_delete(table->expiry_manager, i);
         }
     }
     return evicted_count;
 }
 
 int mac_table_clear(mac_table_t *table) {
+    if (table->approx) {
+        return (int)mac_table_approx_clear(table);
+    }
+
     int cleared_count = 0;
     for (size_t i = 0; i < table->size; i++) {
-        mac_entry_t *entry = &table->entries[i];
-        if (entry->state == SLOT_OCCUPIED) {
-            entry->state = SLOT_TOMBSTONE;
+        if (table->entries[i].state == SLOT_OCCUPIED) {
+            mac_table_release_slot(table, i, MAC_TABLE_DELETED);
             cleared_count++;
-            table->stats->total_deletes++;
-            table->stats->active_entries--;
-
-            if (table->on_event) {
-                table->on_event(i, entry->mac, MAC_TABLE_DELETED);
-            }
-    
-            expiry_manager_delete(table->expiry_manager, i);
         }
     }
     
@@ -306,6 +1521,10 @@ bool mac_table_reset_stats(mac_table_t *table) {
         table->stats->total_inserts = 0;
         table->stats->total_deletes = 0;
         table->stats->total_expired = 0;
+        table->stats->total_flap_damped = 0;
+        table->stats->total_la_rejected = 0;
+        table->stats->total_rate_limited = 0;
+        table->stats->total_filter_rejects = 0;
         return true;
     }
     return false;
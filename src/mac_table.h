@@ -54,8 +54,42 @@ extern "C" {
 #include <string.h>
 #include <time.h>
 
-/* Length of a MAC address in bytes */
+/* Key length in bytes: 6 for MAC-48 (default), 8 for EUI-64 (Thread, Zigbee),
+ * 4 for IPv4. Set it for the whole build, e.g. -DMAC_ADDR_LEN=8; compares of
+ * 4-, 6- and 8-byte keys compile to integer compares. Every public type and
+ * function (tables, rule tables, MPH sets) uses this one width, so a single
+ * image cannot mix key widths. */
+#ifndef MAC_ADDR_LEN
 #define MAC_ADDR_LEN 6
+#endif
+#if MAC_ADDR_LEN < 4 || MAC_ADDR_LEN > 16
+#error "MAC_ADDR_LEN must be between 4 and 16"
+#endif
+
+/* Size of the buffer `mac_to_str()` writes, including the terminator */
+#define MAC_ADDR_STR_LEN (MAC_ADDR_LEN * 3)
+
+#if defined(MAC_TABLE_OUI_COMPRESSION) && MAC_ADDR_LEN != 6
+#error "MAC_TABLE_OUI_COMPRESSION requires 6-byte keys"
+#endif
+
+#ifdef MAC_TABLE_OUI_COMPRESSION
+/* Number of distinct OUIs a compressed-key dictionary can hold (at most 256) */
+#ifndef MAC_TABLE_OUI_DICT_SIZE
+#define MAC_TABLE_OUI_DICT_SIZE 256
+#endif
+#if MAC_TABLE_OUI_DICT_SIZE < 1 || MAC_TABLE_OUI_DICT_SIZE > 256
+#error "MAC_TABLE_OUI_DICT_SIZE must be between 1 and 256 (ids are 8 bits)"
+#endif
+
+/* Buckets of the OUI-to-id hash index, kept at most half full */
+#define MAC_TABLE_OUI_INDEX_SIZE (2 * MAC_TABLE_OUI_DICT_SIZE)
+#endif
+
+/* Number of per-role TTL overrides a table can hold */
+#ifndef MAC_TABLE_MAX_ROLE_TTLS
+#define MAC_TABLE_MAX_ROLE_TTLS 8
+#endif
 
 /**
  * @brief Enum representing the state of a slot in the MAC table.
@@ -66,6 +100,20 @@ typedef enum {
   SLOT_OCCUPIED   /**< Slot is currently occupied */
 } slot_state_t;
 
+/* Entry outlived its TTL and is in the stale stage (see
+ * mac_table_set_stale_timeout) */
+#define MAC_ENTRY_FLAG_STALE 0x01
+
+/* Entry was re-inserted while its flap penalty was above the suppress
+ * threshold and is held with an extended TTL */
+#define MAC_ENTRY_FLAG_DAMPED 0x02
+
+/* Entry is a locally administered (randomized) MAC held in the LA partition */
+#define MAC_ENTRY_FLAG_LOCAL_ADMIN 0x04
+
+/* Locally administered bit in the first octet of a MAC address */
+#define MAC_ADDR_LOCAL_ADMIN_BIT 0x02
+
 /**
  * @brief Enum representing the result of MAC table operations.
  */
@@ -76,18 +124,49 @@ typedef enum {
   MAC_TABLE_INSERTED,  /**< Entry inserted */
   MAC_TABLE_UPDATED,   /**< Existing entry updated */
   MAC_TABLE_DELETED,   /**< Entry deleted */
-  MAC_TABLE_FULL       /**< MAC table is full */
+  MAC_TABLE_FULL,      /**< MAC table is full */
+  MAC_TABLE_HIGH_WATERMARK, /**< Occupancy rose to the high watermark */
+  MAC_TABLE_LOW_WATERMARK,  /**< Occupancy fell back to the low watermark */
+  MAC_TABLE_EXPIRING,       /**< Entry will expire within the warning grace */
+  MAC_TABLE_STALE,          /**< Entry outlived its TTL and became stale */
+  MAC_TABLE_RATE_LIMITED,   /**< Insert or refresh rejected by admission
+                               control */
+  MAC_TABLE_RELOCATED       /**< Entry moved to the reported slot by
+                               `mac_table_relocate_hot()` */
 } mac_entry_result_t;
 
+/* Slot reuse counter; one byte in the compressed layout, where hot cache hits
+ * also confirm the key, so wrapping is harmless */
+#ifdef MAC_TABLE_OUI_COMPRESSION
+typedef uint8_t mac_slot_generation_t;
+#else
+typedef uint16_t mac_slot_generation_t;
+#endif
+
 /**
  * @brief Structure representing a single entry in the MAC table.
+ *
+ * Timestamps come first so the compressed layout packs without padding:
+ * 24 bytes with a 64-bit `time_t` (16 with a 32-bit one), against 32 (24)
+ * for the default layout.
  */
 typedef struct {
-  uint8_t mac[MAC_ADDR_LEN]; /**< MAC address bytes */
   time_t timeout_duration;   /**< Absolute expiration time */
+  time_t last_access; /**< Time of the last lookup hit with sliding expiry
+                         (0 = none since the last insert, refresh or
+                         extension) */
+#ifdef MAC_TABLE_OUI_COMPRESSION
+  uint32_t key; /**< OUI dictionary id (bits 31..24) and NIC bytes (bits
+                   23..0); decode with `mac_table_entry_mac()` */
+  uint8_t state; /**< Current state of this slot (`slot_state_t`) */
+#else
+  uint8_t mac[MAC_ADDR_LEN]; /**< MAC address bytes */
   slot_state_t state;        /**< Current state of this slot */
+#endif
   uint8_t role; /**< Role associated with this MAC address entry (e.g., client,
                    gateway) */
+  uint8_t flags; /**< `MAC_ENTRY_FLAG_*` bits */
+  mac_slot_generation_t generation; /**< Bumped whenever the slot is vacated */
 } mac_entry_t;
 
 /**
@@ -105,6 +184,51 @@ struct mac_table_expiry_manager_t; /**< Forward declaration for expiry manager
 
 typedef struct mac_table_expiry_manager_t mac_table_expiry_manager_t;
 
+struct mac_expiry_scheduler_t; /**< Forward declaration for expiry scheduler
+                                */
+
+/**
+ * @brief Expiry scheduler shared by one or more MAC tables.
+ *
+ * Holds a single merged min-heap of deadlines and a single FreeRTOS timer (or
+ * expiry worker task). Every table owns a private scheduler unless it is
+ * initialized with `mac_table_init_shared()`.
+ */
+typedef struct mac_expiry_scheduler_t mac_expiry_scheduler_t;
+
+struct mac_table_approx_t; /**< Forward declaration for approximate mode
+                            state */
+
+/**
+ * @brief Rotating Bloom filter generations backing an approximate table.
+ */
+typedef struct mac_table_approx_t mac_table_approx_t;
+
+/* Upper bound on filter generations of an approximate table */
+#ifndef MAC_TABLE_MAX_APPROX_GENERATIONS
+#define MAC_TABLE_MAX_APPROX_GENERATIONS 8
+#endif
+
+/**
+ * @brief Sizing of an approximate table (see `mac_table_init_approx()`).
+ */
+typedef struct {
+  size_t capacity;           /**< Distinct MACs expected per expiry window */
+  float false_positive_rate; /**< Target lookup false-positive rate, e.g.
+                                0.01 */
+  uint8_t generations;       /**< Filter generations, 2 to
+                                `MAC_TABLE_MAX_APPROX_GENERATIONS`; more
+                                generations age entries out more precisely */
+} mac_table_approx_config_t;
+
+/**
+ * @brief Read-only snapshot of a table built by `mac_table_freeze()`.
+ */
+typedef struct {
+  uint64_t *records; /**< MAC << 8 | role, in Eytzinger order from index 1 */
+  size_t count;      /**< Number of records */
+} mac_table_frozen_t;
+
 /**
  * @brief Structure for tracking statistics related to the MAC address table.
  *
@@ -119,8 +243,127 @@ typedef struct {
   size_t total_expired;  /**< Total number of entries that have expired */
   size_t active_entries; /**< Number of entries currently active in the table
                             (not expired or deleted) */
+  size_t stale_entries;  /**< Number of active entries in the stale stage */
+  size_t total_flap_damped; /**< Inserts damped by flap suppression */
+  size_t la_entries; /**< Active entries in the locally administered
+                        partition */
+  size_t total_la_rejected; /**< Inserts rejected because the locally
+                               administered partition was full */
+  size_t total_rate_limited; /**< Inserts and refreshes rejected by admission
+                                control */
+  size_t total_filter_rejects; /**< Lookups answered by the Bloom filter
+                                  without probing */
 } mac_table_stats_t;
 
+/* Number of occupancy watermarks for pressure-adaptive aging */
+#ifndef MAC_TABLE_MAX_AGING_LEVELS
+#define MAC_TABLE_MAX_AGING_LEVELS 4
+#endif
+
+/**
+ * @brief One step of pressure-adaptive aging.
+ *
+ * Once occupancy (`active_entries * 100 / size`) reaches `occupancy_percent`,
+ * TTLs are scaled to `ttl_percent` of their configured value.
+ */
+typedef struct {
+  uint8_t occupancy_percent; /**< Fill level at which the step applies */
+  uint8_t ttl_percent;       /**< TTL scale at this step (1-100) */
+} mac_table_aging_level_t;
+
+/**
+ * @brief Flap history record for one MAC address.
+ *
+ * Storage for these records is provided by the caller in
+ * `mac_table_enable_flap_damping()`; fields are managed by the table.
+ */
+typedef struct {
+  uint8_t mac[MAC_ADDR_LEN]; /**< MAC the record tracks */
+  uint16_t penalty;          /**< Penalty at `updated`, before decay */
+  bool expired;              /**< MAC expired and has not been re-inserted */
+  time_t updated;            /**< Time of the last penalty update */
+} mac_flap_record_t;
+
+/**
+ * @brief Flap damping parameters.
+ *
+ * Each re-insert of a MAC shortly after it expired adds `flap_penalty`. The
+ * penalty halves every `half_life_seconds`. A MAC re-inserted with a penalty
+ * at or above `suppress_threshold` is damped: its TTL is multiplied by
+ * `ttl_multiplier` so it stays in the table through its next silence instead
+ * of cycling through expiry and re-insertion again.
+ */
+typedef struct {
+  uint16_t flap_penalty;       /**< Penalty added per flap */
+  uint16_t suppress_threshold; /**< Penalty at which inserts are damped */
+  uint32_t half_life_seconds;  /**< Penalty half-life */
+  uint8_t ttl_multiplier;      /**< TTL factor for damped entries */
+} mac_table_flap_config_t;
+
+/**
+ * @brief Admission control limits for `mac_table_insert_ex()`.
+ */
+typedef struct {
+  uint32_t inserts_per_second;  /**< Sustained rate of new entries
+                                   (0 = unlimited) */
+  uint32_t insert_burst;        /**< Token bucket depth for new entries */
+  uint32_t min_refresh_seconds; /**< Minimum deadline extension for a plain
+                                   refresh of the same MAC to be accepted
+                                   (0 = unlimited) */
+} mac_table_admission_config_t;
+
+#ifdef MAC_TABLE_OUI_COMPRESSION
+/**
+ * @brief OUI dictionary of compressed-key tables.
+ *
+ * Maps each vendor prefix in use to an 8-bit id stored in `mac_entry_t::key`,
+ * through a small hash index so finding an OUI's id costs one probe rather
+ * than a scan. Ids are reference counted and recycled once no entry uses
+ * them. A zero-initialized dictionary is empty. One
+ * dictionary may be shared by several tables with
+ * `mac_table_share_oui_dict()`.
+ */
+typedef struct {
+  uint32_t oui[MAC_TABLE_OUI_DICT_SIZE];  /**< OUI bytes packed big-endian */
+  uint32_t refs[MAC_TABLE_OUI_DICT_SIZE]; /**< Entries using each id (0 =
+                                             free) */
+  uint16_t index[MAC_TABLE_OUI_INDEX_SIZE]; /**< Open-addressed OUI to id + 1
+                                               map (0 = empty bucket) */
+} mac_oui_dict_t;
+#endif
+
+/**
+ * @brief One line of the hot-entry lookup cache.
+ *
+ * Storage is provided by the caller in `mac_table_enable_hot_cache()`; fields
+ * are managed by the table.
+ */
+typedef struct {
+  uint8_t mac[MAC_ADDR_LEN]; /**< Cached MAC */
+  mac_slot_generation_t generation; /**< Slot generation when the line was
+                                       filled */
+  int32_t slot;              /**< Slot holding `mac`, or -1 if unused */
+} mac_hot_cache_line_t;
+
+/**
+ * @brief One counter of the heavy-hitter tracker.
+ *
+ * The true activity of `mac` lies between `count - error` and `count`.
+ */
+typedef struct {
+  uint8_t mac[MAC_ADDR_LEN]; /**< Monitored MAC */
+  uint32_t count;            /**< Inserts, touches and lookup hits counted */
+  uint32_t error;            /**< Maximum overestimate of `count` */
+} mac_heavy_hitter_t;
+
+/**
+ * @brief Default lifetime for entries of one role.
+ */
+typedef struct {
+  uint8_t role;         /**< Role the TTL applies to */
+  uint32_t ttl_seconds; /**< Lifetime used when no custom duration is given */
+} mac_role_ttl_t;
+
 /**
  * @brief Structure representing the MAC address table.
  *
@@ -136,8 +379,80 @@ typedef struct {
   mac_table_event_callback_t on_event; /**< Callback for events */
   mac_table_expiry_manager_t *expiry_manager; /**< Expiry manager pointer */
   mac_table_stats_t *stats; /**< Pointer to the statistics structure */
+  uint8_t ttl_jitter_percent; /**< Per-MAC TTL spread in percent (0 = off) */
+  mac_role_ttl_t role_ttls[MAC_TABLE_MAX_ROLE_TTLS]; /**< Per-role TTLs */
+  size_t role_ttl_count; /**< Number of valid entries in `role_ttls` */
+  mac_table_aging_level_t
+      aging_levels[MAC_TABLE_MAX_AGING_LEVELS]; /**< Aging watermarks */
+  size_t aging_level_count; /**< Number of valid entries in `aging_levels` */
+  size_t aging_level; /**< Current aging step (0 = no pressure) */
+  uint8_t high_watermark_percent; /**< High occupancy watermark (0 = off) */
+  uint8_t low_watermark_percent;  /**< Low occupancy watermark */
+  bool above_high_watermark; /**< Set between high and low crossings */
+  bool sliding_expiry; /**< Lookup hits extend an entry's lifetime */
+  uint32_t expiry_warning_seconds; /**< Lead time of `MAC_TABLE_EXPIRING`
+                                      (0 = off) */
+  uint32_t stale_seconds; /**< Time an expired entry stays stale before
+                             removal (0 = no stale stage) */
+  mac_flap_record_t *flap_records; /**< Flap history (NULL = damping off) */
+  size_t flap_record_count;        /**< Number of flap history records */
+  mac_table_flap_config_t flap_config; /**< Flap damping parameters */
+  size_t la_max_entries;   /**< Cap on locally administered entries
+                              (0 = no partition) */
+  uint32_t la_ttl_seconds; /**< TTL for locally administered entries
+                              (0 = normal TTL) */
+  mac_table_admission_config_t admission; /**< Admission control limits */
+  uint32_t admission_tokens;  /**< Tokens left for new entries */
+  time_t admission_refilled;  /**< Last token bucket refill */
+  mac_hot_cache_line_t *hot_cache; /**< Hot-entry cache (NULL = off) */
+  size_t hot_cache_size;           /**< Number of hot cache lines */
+  uint8_t *filter;       /**< Counting Bloom filter counters (NULL = off) */
+  size_t filter_size;    /**< Number of filter counters */
+  uint8_t filter_hashes; /**< Counters probed per MAC */
+  mac_table_approx_t *approx; /**< Approximate mode state (NULL = exact) */
+  uint8_t *hll_registers;     /**< Distinct-MAC sketch registers, one block
+                                 per generation (NULL = off) */
+  size_t hll_register_count;  /**< Registers per generation */
+  uint8_t hll_index_bits;     /**< log2(`hll_register_count`) */
+  uint8_t hll_generations;    /**< Sketch generations covering the window */
+  uint8_t hll_current;        /**< Generation receiving updates */
+  time_t hll_period;          /**< Seconds between generation rotations */
+  time_t hll_rotated;         /**< Time of the last rotation */
+  mac_heavy_hitter_t *heavy_hitters; /**< Top-K counters (NULL = off) */
+  size_t heavy_hitter_count;         /**< Number of top-K counters */
+  uint16_t *hit_counters; /**< Per-slot lookup hits, parallel to `entries`
+                             (NULL = off) */
+  uint64_t *index;    /**< Ordered index records sorted by MAC (NULL = off) */
+  size_t index_count; /**< Number of valid records in `index` */
+#ifdef MAC_TABLE_OUI_COMPRESSION
+  mac_oui_dict_t *oui_dict; /**< OUI dictionary for compressed keys */
+  bool owns_oui_dict;       /**< `oui_dict` was allocated by the table */
+#endif
 } mac_table_t;
 
+/* Pass as `core_id` to let the scheduler run the expiry worker on any core */
+#define MAC_TABLE_NO_AFFINITY (-1)
+
+/* Stack depth used for the expiry worker when `stack_size` is 0 */
+#define MAC_TABLE_EXPIRY_WORKER_STACK 2048
+
+/**
+ * @brief Configuration for a dedicated expiry worker task.
+ *
+ * By default expiry runs inside the FreeRTOS timer service task, shared with
+ * every other software timer in the system. A worker task isolates expiry
+ * processing (and the `on_event` callbacks it fires) with its own priority and,
+ * on ESP32, its own core.
+ */
+typedef struct {
+  UBaseType_t priority; /**< FreeRTOS priority of the worker task */
+  BaseType_t core_id;   /**< Core to pin the worker to, or
+                           `MAC_TABLE_NO_AFFINITY` (ignored on single-core
+                           ports) */
+  uint32_t stack_size;  /**< Stack depth for the worker task, 0 for
+                           `MAC_TABLE_EXPIRY_WORKER_STACK` */
+} mac_table_expiry_worker_config_t;
+
 /**
  * @brief Structure representing options for inserting a MAC address into the
  * table.
@@ -161,8 +476,9 @@ typedef struct {
  * @brief Insert a MAC address into the table.
  *
  * This function inserts a MAC address into the MAC address table. If the
- * address already exists, it will update the existing entry's expiration time
- * and role.
+ * address already exists, it will refresh the existing entry's expiration time
+ * and keep its role. The lifetime is the TTL configured for the entry's role
+ * with `mac_table_set_role_ttl()`, or the table's `expiry_seconds`.
  *
  * @param table Pointer to the MAC address table.
  * @param mac The MAC address to insert.
@@ -182,7 +498,10 @@ mac_entry_result_t mac_table_insert(mac_table_t *table, const uint8_t *mac);
  * This function inserts a MAC address into the MAC address table with
  * additional options, such as custom expiration duration or role. If the
  * address already exists, it will update the existing entry's expiration time,
- * role, and other properties based on the provided options.
+ * role, and other properties based on the provided options. Without
+ * `has_role`, new entries get role 0 and existing entries keep their role;
+ * without `has_custom_duration`, the per-role TTL (if any) or the table's
+ * `expiry_seconds` is used.
  *
  * @param table Pointer to the MAC address table.
  * @param mac The MAC address to insert or update.
@@ -195,6 +514,8 @@ mac_entry_result_t mac_table_insert(mac_table_t *table, const uint8_t *mac);
  *         - MAC_TABLE_UPDATED: The MAC address already exists and was updated.
  *         - MAC_TABLE_FULL: The table is full and cannot accommodate the new
  * entry.
+ *         - MAC_TABLE_RATE_LIMITED: Rejected by admission control; no event
+ * is fired.
  *         - MAC_TABLE_NOT_FOUND: The MAC address or table is invalid.
  */
 mac_entry_result_t mac_table_insert_ex(mac_table_t *table, const uint8_t *mac,
@@ -208,6 +529,21 @@ mac_entry_result_t mac_table_insert_ex(mac_table_t *table, const uint8_t *mac,
  */
 mac_table_expiry_manager_t *expiry_manager_create(mac_table_t *table);
 
+/**
+ * @brief Create an expiry manager that registers the table with a shared
+ * scheduler.
+ *
+ * The scheduler's heap is grown so that every slot of `table` can be pending
+ * at the same time.
+ *
+ * @param table Pointer to the MAC table.
+ * @param scheduler Scheduler the table's deadlines are merged into.
+ * @return Pointer to the created expiry manager, or NULL on failure.
+ */
+mac_table_expiry_manager_t *
+expiry_manager_create_shared(mac_table_t *table,
+                             mac_expiry_scheduler_t *scheduler);
+
 /**
  * @brief Free resources associated with the expiry manager.
  *
@@ -220,8 +556,10 @@ void expiry_manager_free(mac_table_expiry_manager_t *manager);
  *
  * @param manager Pointer to the expiry manager.
  * @param slot_index Index of the slot to add or update.
+ * @return true if the slot's deadline is queued, false on invalid arguments
+ * or when the deadline heap could not grow.
  */
-void expiry_manager_add_or_update(mac_table_expiry_manager_t *manager,
+bool expiry_manager_add_or_update(mac_table_expiry_manager_t *manager,
                                   size_t slot_index);
 
 /**
@@ -233,6 +571,111 @@ void expiry_manager_add_or_update(mac_table_expiry_manager_t *manager,
 void expiry_manager_delete(mac_table_expiry_manager_t *manager,
                            size_t slot_index);
 
+/**
+ * @brief Run expiry processing in a dedicated task instead of a timer.
+ *
+ * Creates a worker task that sleeps until the earliest deadline and is woken
+ * by task notification whenever that deadline changes. The table's FreeRTOS
+ * software timer is deleted once the worker is running, so expiry no longer
+ * competes with other timers in the timer service task.
+ *
+ * The scheduler's deadline heap is guarded by a recursive mutex, but expiry
+ * also updates table entries from the worker. If the worker may run on a
+ * different core than the tasks using the table, wrap table calls in
+ * `mac_table_lock()` / `mac_table_unlock()`.
+ *
+ * @param table Pointer to an initialized MAC table.
+ * @param config Priority, core affinity and stack size of the worker.
+ * @return true if the worker was started, false if the arguments are invalid,
+ * a worker is already running, or the task could not be created.
+ */
+bool mac_table_start_expiry_worker(
+    mac_table_t *table, const mac_table_expiry_worker_config_t *config);
+
+/**
+ * @brief Hold the table's expiry scheduler lock.
+ *
+ * Holds off expiry processing for every table on the same scheduler until
+ * `mac_table_unlock()`. The worker task waits for the lock; the timer
+ * callback never blocks the timer service task and retries every 10 ms
+ * instead. The lock is recursive, so table calls made while holding it,
+ * including from `on_event` callbacks, do not deadlock.
+ *
+ * @param table Pointer to an initialized MAC table.
+ */
+void mac_table_lock(mac_table_t *table);
+
+/**
+ * @brief Release the lock taken by `mac_table_lock()`.
+ *
+ * @param table Pointer to an initialized MAC table.
+ */
+void mac_table_unlock(mac_table_t *table);
+
+/**
+ * @brief Set the expiry slack window for the table's scheduler.
+ *
+ * With a slack of N seconds the timer is only armed for multiples of N, and
+ * every deadline that falls inside the same N-second bucket is expired by a
+ * single wakeup. Entries may therefore outlive their deadline by up to N - 1
+ * seconds, but never expire early. If the table shares its scheduler, the
+ * window applies to all tables on it.
+ *
+ * @param table Pointer to an initialized MAC table.
+ * @param slack_seconds Bucket width in seconds; 0 or 1 disables coalescing.
+ * @return true on success, false if the table has no expiry manager.
+ */
+bool mac_table_set_expiry_slack(mac_table_t *table, uint32_t slack_seconds);
+
+/**
+ * @brief Set the expiry slack window of a scheduler.
+ *
+ * See `mac_table_set_expiry_slack()`.
+ *
+ * @param scheduler Pointer to the scheduler.
+ * @param slack_seconds Bucket width in seconds; 0 or 1 disables coalescing.
+ * @return true on success, false if `scheduler` is NULL.
+ */
+bool mac_expiry_scheduler_set_slack(mac_expiry_scheduler_t *scheduler,
+                                    uint32_t slack_seconds);
+
+/**
+ * @brief Create an expiry scheduler that many tables can share.
+ *
+ * Tables registered with `mac_table_init_shared()` merge their deadlines into
+ * the scheduler's heap and are served by its one timer, instead of each table
+ * allocating its own heap and timer.
+ *
+ * @param capacity Initial number of pending deadlines to reserve. The heap
+ * grows as tables register, so 0 is valid.
+ * @return Pointer to the scheduler, or NULL on allocation failure.
+ */
+mac_expiry_scheduler_t *mac_expiry_scheduler_create(size_t capacity);
+
+/**
+ * @brief Free an expiry scheduler.
+ *
+ * All tables using the scheduler must have released their expiry managers
+ * (`expiry_manager_free()`) first.
+ *
+ * @param scheduler Pointer to the scheduler.
+ */
+void mac_expiry_scheduler_free(mac_expiry_scheduler_t *scheduler);
+
+/**
+ * @brief Run a scheduler's expiry processing in a dedicated task.
+ *
+ * Same as `mac_table_start_expiry_worker()`, applied to every table
+ * registered with the scheduler.
+ *
+ * @param scheduler Pointer to the scheduler.
+ * @param config Priority, core affinity and stack size of the worker.
+ * @return true if the worker was started, false otherwise.
+ */
+bool mac_expiry_scheduler_start_worker(
+    mac_expiry_scheduler_t *scheduler,
+    const mac_table_expiry_worker_config_t *config);
+
 /**
  * @brief Initialize a MAC address table.
  *
@@ -251,6 +694,64 @@ void expiry_manager_delete(mac_table_expiry_manager_t *manager,
 bool mac_table_init(mac_table_t *table, mac_entry_t *entries, size_t size,
                     size_t expiry_seconds, mac_table_event_callback_t on_event);
 
+/**
+ * @brief Initialize a MAC address table on a shared expiry scheduler.
+ *
+ * Identical to `mac_table_init()`, except that the table's deadlines are kept
+ * in `scheduler` and dispatched by its timer rather than by a per-table heap
+ * and timer. Events are still delivered to each table's own `on_event`.
+ *
+ * @param table Pointer to the MAC address table to initialize.
+ * @param entries Pointer to an array of MAC entries to store in the table.
+ * @param size The size of the `entries` array.
+ * @param expiry_seconds The expiration timeout for each entry in seconds.
+ * @param on_event Callback for table events.
+ * @param scheduler Scheduler created with `mac_expiry_scheduler_create()`.
+ * @return true if the table was successfully initialized, false otherwise.
+ */
+bool mac_table_init_shared(mac_table_t *table, mac_entry_t *entries,
+                           size_t size, size_t expiry_seconds,
+                           mac_table_event_callback_t on_event,
+                           mac_expiry_scheduler_t *scheduler);
+
+/**
+ * @brief Initialize a MAC address table in approximate mode.
+ *
+ * Instead of `mac_entry_t` slots, the table keeps `config->generations`
+ * Bloom filters. Inserts set bits in the newest generation; lookups test all
+ * of them; every `expiry_seconds / (generations - 1)` the oldest generation
+ * is cleared and becomes the newest. A MAC therefore stays present for at
+ * least `expiry_seconds` and less than `expiry_seconds * generations /
+ * (generations - 1)` after its last insert.
+ *
+ * `mac_table_insert()`, `mac_table_insert_ex()` (options ignored),
+ * `mac_table_touch()`, `mac_table_exists()` and `mac_table_clear()` keep
+ * their meaning, except that lookups of absent MACs succeed with
+ * probability up to `config->false_positive_rate`. `mac_table_delete()`
+ * always returns `MAC_TABLE_NOT_FOUND`, and per-slot functions see an empty
+ * table. Setters for per-entry behaviour (TTL policies, aging, watermarks,
+ * partitions, admission control, caches, filters, hit counters and the
+ * ordered index) return `false`; the distinct estimator and heavy hitters
+ * work in both modes. `active_entries` and `total_expired` in the statistics are
+ * estimates. Insert and update events are delivered with slot index -1;
+ * expiry is silent.
+ *
+ * Memory is about `1.44 * log2(generations / rate)` bits per MAC per
+ * generation: roughly 6 bytes per MAC for 1% and 4 generations, against
+ * `sizeof(mac_entry_t)` plus heap bookkeeping for an exact table.
+ *
+ * @param table Pointer to the MAC address table to initialize.
+ * @param config Capacity and accuracy of the filters.
+ * @param expiry_seconds Minimum lifetime of an inserted MAC in seconds.
+ * @param on_event Callback for insert and update events (may be NULL).
+ * @return true if the table was successfully initialized, false on invalid
+ * arguments or allocation failure.
+ */
+bool mac_table_init_approx(mac_table_t *table,
+                           const mac_table_approx_config_t *config,
+                           size_t expiry_seconds,
+                           mac_table_event_callback_t on_event);
+
 /**
  * @brief Insert or update a MAC address in the table.
  *
@@ -260,9 +761,27 @@ bool mac_table_init(mac_table_t *table, mac_entry_t *entries, size_t size,
  */
 mac_entry_result_t mac_table_insert(mac_table_t *table, const uint8_t *mac);
 
+/**
+ * @brief Refresh an existing entry without firing a callback.
+ *
+ * Renews the entry's lifetime with its role or default TTL and revives it if
+ * it is stale. Unlike `mac_table_insert()`, neither `MAC_TABLE_UPDATED` nor
+ * `MAC_TABLE_INSERTED` is reported to `on_event`, and unknown MACs are not
+ * added.
+ *
+ * @param table Pointer to the MAC table.
+ * @param mac MAC address to refresh.
+ * @return `MAC_TABLE_UPDATED` if the entry was refreshed, otherwise
+ * `MAC_TABLE_NOT_FOUND`.
+ */
+mac_entry_result_t mac_table_touch(mac_table_t *table, const uint8_t *mac);
+
 /**
  * @brief Check if a MAC address exists in the table.
  *
+ * With sliding expiry enabled, a hit records the access time in the entry's
+ * slot (the table structure itself is not modified).
+ *
  * @param table Pointer to the MAC table.
  * @param mac MAC address to check.
  * @return Result of the existence check.
@@ -349,6 +868,494 @@ int mac_table_evict_by_role(mac_table_t *table, uint8_t role);
  */
 int mac_table_clear(mac_table_t *table);
 
+/**
+ * @brief Enables randomized TTL jitter for inserted and refreshed entries.
+ *
+ * Each entry's lifetime is offset by up to +/- `percent` of its TTL, so peers
+ * refreshed in the same tick do not all expire in the same second. The offset
+ * is derived from a hash of the MAC address, so a given MAC always receives
+ * the same offset and behaviour stays reproducible.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param percent Maximum deviation in percent of the TTL (0 disables, max
+ * 100).
+ *
+ * @return `true` on success, `false` if `table` is NULL or `percent` is out of
+ * range.
+ */
+bool mac_table_set_ttl_jitter(mac_table_t *table, uint8_t percent);
+
+/**
+ * @brief Sets the default TTL for entries with the given role.
+ *
+ * Inserts and refreshes that do not carry a custom duration use the TTL of
+ * the entry's role, so callers only need to pass the MAC on the hot path and
+ * lifetime policy lives in one place. Changes apply from the next insert or
+ * refresh of each entry.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param role The role to configure.
+ * @param ttl_seconds Lifetime for the role, or 0 to fall back to the table's
+ * `expiry_seconds`.
+ *
+ * @return `true` on success, `false` if `table` is NULL or all
+ * `MAC_TABLE_MAX_ROLE_TTLS` overrides are in use.
+ */
+bool mac_table_set_role_ttl(mac_table_t *table, uint8_t role,
+                            uint32_t ttl_seconds);
+
+/**
+ * @brief Enables pressure-adaptive aging (early drop).
+ *
+ * As occupancy crosses each watermark, the TTL given to inserted and refreshed
+ * entries shrinks to the level's `ttl_percent`. When a higher level is
+ * entered, the remaining lifetime of every entry already in the table is
+ * scaled down by the same ratio, so idle entries are shed before the table
+ * reports `MAC_TABLE_FULL`. Falling back to a lower level does not extend
+ * existing entries; they regain full TTLs on their next refresh.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param levels Watermarks sorted by increasing `occupancy_percent` and
+ * non-increasing `ttl_percent`.
+ * @param count Number of levels, up to `MAC_TABLE_MAX_AGING_LEVELS`; 0
+ * disables adaptive aging.
+ *
+ * @return `true` on success, `false` if the arguments are invalid.
+ */
+bool mac_table_set_adaptive_aging(mac_table_t *table,
+                                  const mac_table_aging_level_t *levels,
+                                  size_t count);
+
+/**
+ * @brief Configures occupancy watermark notifications.
+ *
+ * When occupancy rises to `high_percent`, `on_event` is called once with
+ * `MAC_TABLE_HIGH_WATERMARK`; it is not called again until occupancy has
+ * fallen to `low_percent`, which fires `MAC_TABLE_LOW_WATERMARK`. Both events
+ * use slot index -1 and pass the MAC whose insertion or removal crossed the
+ * watermark. Producers can use them to throttle scanning or start evicting
+ * before inserts fail.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param high_percent Occupancy that raises the high event; 0 disables.
+ * @param low_percent Occupancy that re-arms it; must be below
+ * `high_percent`.
+ *
+ * @return `true` on success, `false` if the arguments are invalid.
+ */
+bool mac_table_set_watermarks(mac_table_t *table, uint8_t high_percent,
+                              uint8_t low_percent);
+
+/**
+ * @brief Enables sliding expiration on lookup hits.
+ *
+ * A `mac_table_exists()` hit stamps the entry's `last_access`. The expiry
+ * heap is not touched on the lookup path; when the entry's deadline comes
+ * due after a hit, it is pushed to the time of that hit plus the lifetime
+ * the entry's last insert or refresh granted (custom duration, role or
+ * default TTL), so actively used peers stay alive without explicit
+ * refreshes. Entries that saw no hit expire on schedule.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param enable `true` to enable sliding expiry, `false` to disable it.
+ *
+ * @return `true` on success, `false` if `table` is NULL.
+ */
+bool mac_table_set_sliding_expiry(mac_table_t *table, bool enable);
+
+/**
+ * @brief Enables pre-expiry warning events.
+ *
+ * `grace_seconds` before an entry expires, the expiry manager calls
+ * `on_event` with `MAC_TABLE_EXPIRING`. Refreshing the entry from the callback
+ * (or any time before the deadline) cancels the pending expiry, so a peer can
+ * be probed and kept instead of being removed and re-added. Applies to entries
+ * scheduled after the call.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param grace_seconds Warning lead time; 0 disables warnings.
+ *
+ * @return `true` on success, `false` if `table` is NULL.
+ */
+bool mac_table_set_expiry_warning(mac_table_t *table, uint32_t grace_seconds);
+
+/**
+ * @brief Enables the stale aging stage (active -> stale -> gone).
+ *
+ * When an entry's TTL runs out it is not removed; it is flagged
+ * `MAC_ENTRY_FLAG_STALE`, reported once with `MAC_TABLE_STALE` and kept
+ * resolvable for `stale_seconds`. A refresh, touch or (with sliding expiry)
+ * lookup during that time revives it without an `MAC_TABLE_INSERTED` event.
+ * Only when the stale period also passes is it removed with
+ * `MAC_TABLE_TIMEOUT`. Pre-expiry warnings, if enabled, are sent before that
+ * final removal.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param stale_seconds Length of the stale stage; 0 removes entries as soon
+ * as their TTL runs out.
+ *
+ * @return `true` on success, `false` if `table` is NULL.
+ */
+bool mac_table_set_stale_timeout(mac_table_t *table, uint32_t stale_seconds);
+
+/**
+ * @brief Enables flap damping for MACs that repeatedly expire and return.
+ *
+ * Expired MACs are remembered in a small direct-mapped history. A re-insert of
+ * a remembered MAC is charged a penalty that decays over time; once it reaches
+ * the suppress threshold the new entry is flagged `MAC_ENTRY_FLAG_DAMPED` and
+ * kept for `ttl_multiplier` times its normal TTL, bounding the callback and
+ * peer-list churn each oscillating device can cause. Damped inserts are
+ * counted in `total_flap_damped`.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param records Caller-owned history storage, or NULL to disable damping.
+ * @param count Number of records in `records`.
+ * @param config Damping parameters (required when enabling).
+ *
+ * @return `true` on success, `false` if the arguments are invalid.
+ */
+bool mac_table_enable_flap_damping(mac_table_t *table,
+                                   mac_flap_record_t *records, size_t count,
+                                   const mac_table_flap_config_t *config);
+
+/**
+ * @brief Confines randomized MACs to a capped, short-TTL partition.
+ *
+ * MACs with the locally administered bit set (as used by phones and laptops
+ * for address randomization) are counted against `max_entries` and, unless a
+ * custom duration is given, live for `ttl_seconds`. New locally administered
+ * MACs beyond the cap are rejected with `MAC_TABLE_FULL` and counted in
+ * `total_la_rejected`, so a randomized MAC storm cannot take the slots of
+ * globally unique infrastructure peers. Entries already in the table are not
+ * reclassified. The bit is only meaningful in MAC-48 keys, so the partition
+ * can only be enabled when `MAC_ADDR_LEN` is 6.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param max_entries Maximum number of locally administered entries; 0
+ * disables the partition.
+ * @param ttl_seconds Lifetime of locally administered entries; 0 keeps the
+ * role or default TTL.
+ *
+ * @return `true` on success, `false` if `table` is NULL, `max_entries`
+ * exceeds the table size, or `max_entries` is nonzero and keys are not 6
+ * bytes wide.
+ */
+bool mac_table_set_la_partition(mac_table_t *table, size_t max_entries,
+                                uint32_t ttl_seconds);
+
+/**
+ * @brief Enables admission control for inserts.
+ *
+ * New entries draw from a global token bucket refilled at
+ * `inserts_per_second` up to `insert_burst`; only inserts that find a free
+ * slot spend a token, so a full table does not drain the budget. A plain
+ * refresh of an existing MAC is accepted only if it would move the entry's
+ * deadline out by at least `min_refresh_seconds`, so keepalives arriving
+ * faster than that are dropped while an entry close to expiry is always
+ * renewed. Refreshes that change the role, pass a custom duration or revive
+ * a stale entry are never limited. Rejected
+ * calls return `MAC_TABLE_RATE_LIMITED` without touching the expiry heap or
+ * firing `on_event`, and are counted in `total_rate_limited`, so a MAC
+ * spoofing flood or a device spamming keepalives costs a counter increment
+ * per frame.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param config Limits to apply, or NULL to disable admission control.
+ *
+ * @return `true` on success, `false` if `table` is NULL or the bucket has a
+ * rate but no depth.
+ */
+bool mac_table_set_admission_control(
+    mac_table_t *table, const mac_table_admission_config_t *config);
+
+/**
+ * @brief Enables a small direct-mapped cache of recently resolved MACs.
+ *
+ * `mac_table_exists()`, `mac_table_insert_ex()`, `mac_table_touch()` and
+ * `mac_table_delete()` first check the cache line selected by the MAC's last
+ * bytes; a hit whose slot generation is unchanged skips hashing and probing.
+ * Lines are invalidated implicitly when their slot is vacated. 8 to 32 lines
+ * are usually enough for skewed traffic.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param lines Caller-owned cache storage, or NULL to disable the cache.
+ * @param count Number of lines; must be a power of two.
+ *
+ * @return `true` on success, `false` if `table` is NULL or `count` is not a
+ * power of two.
+ */
+bool mac_table_enable_hot_cache(mac_table_t *table,
+                                mac_hot_cache_line_t *lines, size_t count);
+
+/**
+ * @brief Enables a counting Bloom filter in front of `mac_table_exists()`.
+ *
+ * The filter is updated on every insert, delete and expiry. A lookup whose
+ * counters include a zero returns `MAC_TABLE_NOT_FOUND` without probing the
+ * table; other lookups fall through to the normal probe. Counters saturate at
+ * 255 and are never decremented afterwards, which can only cost false
+ * positives. Entries already in the table are added when the filter is
+ * enabled.
+ *
+ * With `count` around 8 counters per table slot and `hashes` = 4, fewer than
+ * 3% of misses reach the table.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param counters Caller-owned counter storage, or NULL to disable the
+ * filter.
+ * @param count Number of counters; must be a power of two.
+ * @param hashes Counters probed per MAC (at least 1).
+ *
+ * @return `true` on success, `false` if `table` is NULL, `count` is not a
+ * power of two or `hashes` is 0.
+ */
+bool mac_table_enable_filter(mac_table_t *table, uint8_t *counters,
+                             size_t count, uint8_t hashes);
+
+/**
+ * @brief Enables a HyperLogLog estimate of distinct MACs offered to the
+ * table.
+ *
+ * Every call to `mac_table_insert()` / `mac_table_insert_ex()` updates the
+ * sketch, including attempts rejected as full or rate limited, so the
+ * estimate reflects demand rather than what the table could hold. The
+ * standard error is about `1.04 / sqrt(count)`: 256 registers give ~6.5%.
+ *
+ * With `generations` > 1 the sketch covers a sliding window: every
+ * `window_seconds / (generations - 1)` the oldest generation is cleared, so
+ * the estimate counts MACs seen in the last `window_seconds` plus at most
+ * one rotation period. With `generations` = 1 it counts since enabling.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param registers Caller-owned storage of `count * generations` bytes, or
+ * NULL to disable the estimator.
+ * @param count Registers per generation; a power of two from 16 to 65536.
+ * @param generations Number of generations (at least 1).
+ * @param window_seconds Sliding window length; ignored with one generation.
+ *
+ * @return `true` on success, `false` on invalid arguments.
+ */
+bool mac_table_enable_distinct_estimator(mac_table_t *table,
+                                         uint8_t *registers, size_t count,
+                                         uint8_t generations,
+                                         uint32_t window_seconds);
+
+/**
+ * @brief Estimated number of distinct MACs offered to the table in the
+ * window configured with `mac_table_enable_distinct_estimator()`.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ *
+ * @return The estimate, or 0 if the estimator is not enabled.
+ */
+size_t mac_table_estimate_distinct(mac_table_t *table);
+
+/**
+ * @brief Enables tracking of the most active MACs (Space-Saving).
+ *
+ * Every insert attempt (including ones rejected as full or rate limited),
+ * `mac_table_touch()` and `mac_table_exists()` hits are counted against `k`
+ * counters, so a MAC flooding the table shows up even when none of its
+ * inserts get in. Any MAC with more than `1/k` of all counted operations is
+ * guaranteed to be monitored; a MAC not monitored replaces the one with the
+ * lowest count.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param counters Caller-owned storage for `k` counters, or NULL to disable
+ * tracking.
+ * @param k Number of counters; a few times the number of hitters wanted.
+ *
+ * @return `true` on success, `false` if `table` is NULL.
+ */
+bool mac_table_enable_heavy_hitters(mac_table_t *table,
+                                    mac_heavy_hitter_t *counters, size_t k);
+
+/**
+ * @brief Copies the most active MACs, highest count first.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param out Array receiving up to `max` counters.
+ * @param max Capacity of `out`.
+ *
+ * @return Number of counters copied.
+ */
+size_t mac_table_get_heavy_hitters(const mac_table_t *table,
+                                   mac_heavy_hitter_t *out, size_t max);
+
+/**
+ * @brief Enables per-slot hit counters used by `mac_table_relocate_hot()`.
+ *
+ * Lookup hits (`mac_table_exists()`, `mac_table_touch()` and refreshes
+ * through `mac_table_insert_ex()`) increment the counter of the slot they
+ * land on, saturating at 65535.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param counters Caller-owned array of `table->size` counters, or NULL to
+ * disable counting.
+ *
+ * @return `true` on success, `false` if `table` is NULL.
+ */
+bool mac_table_enable_hit_counters(mac_table_t *table, uint16_t *counters);
+
+/**
+ * @brief Moves frequently hit entries closer to their home slot.
+ *
+ * For every displaced entry, the first slot on its probe path that is a
+ * tombstone or holds an entry with fewer hits is taken: the hot entry moves
+ * there and the colder one (if any) takes its old slot, which is still on the
+ * colder entry's probe path. Pending expiry deadlines follow their entries,
+ * hot cache lines for both slots are invalidated and `on_event` reports each
+ * moved entry with `MAC_TABLE_RELOCATED` and its new slot. Counters are
+ * halved afterwards so the next pass favours recent traffic.
+ *
+ * Meant to be called periodically from the task that owns the table, e.g.
+ * every few seconds. Does nothing unless hit counters are enabled.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ *
+ * @return Number of hot entries moved.
+ */
+size_t mac_table_relocate_hot(mac_table_t *table);
+
+/**
+ * @brief Enables an ordered index over the table's MACs.
+ *
+ * Keeps one 64-bit record per occupied slot sorted by MAC, updated on
+ * insert, removal and relocation (an O(n) shift, cheap at embedded table
+ * sizes). Prefix, range and successor queries then cost O(log n + k) instead
+ * of a scan with `mac_table_get_by_index()`. Entries already in the table are
+ * indexed when the index is enabled.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param records Caller-owned array of `table->size` records, or NULL to
+ * disable the index.
+ *
+ * @return `true` on success, `false` if `table` is NULL, has more than
+ * 65536 slots, or keys are wider than 6 bytes.
+ */
+bool mac_table_enable_ordered_index(mac_table_t *table, uint64_t *records);
+
+/**
+ * @brief Slots of all entries whose MAC starts with `oui`, in MAC order.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param oui The 3-byte vendor prefix.
+ * @param slots Array receiving up to `max` slot indices.
+ * @param max Capacity of `slots`.
+ *
+ * @return Number of slots written; 0 if the ordered index is disabled.
+ */
+size_t mac_table_find_by_oui(const mac_table_t *table, const uint8_t *oui,
+                             size_t *slots, size_t max);
+
+/**
+ * @brief Slots of all entries with `first` <= MAC <= `last`, in MAC order.
+ *
+ * A range from 00:00:00:00:00:00 to FF:FF:FF:FF:FF:FF gives a sorted dump.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param first Lower bound (inclusive).
+ * @param last Upper bound (inclusive).
+ * @param slots Array receiving up to `max` slot indices.
+ * @param max Capacity of `slots`.
+ *
+ * @return Number of slots written; 0 if the ordered index is disabled.
+ */
+size_t mac_table_find_range(const mac_table_t *table, const uint8_t *first,
+                            const uint8_t *last, size_t *slots, size_t max);
+
+/**
+ * @brief Slot of the entry with the smallest MAC greater than `mac`.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param mac The MAC to start after, or NULL for the smallest MAC.
+ *
+ * @return The slot index, or -1 if there is none or the ordered index is
+ * disabled.
+ */
+int mac_table_find_next(const mac_table_t *table, const uint8_t *mac);
+
+/**
+ * @brief Builds a read-only lookup snapshot of the table.
+ *
+ * The snapshot stores one 64-bit record (MAC and role) per entry in
+ * Eytzinger order, so a lookup is a branch-free descent whose first levels
+ * share a few cache lines. It holds no pointers into the table and is never
+ * modified, so readers on any core may use it without locks while the live
+ * table keeps absorbing changes. To publish changes, freeze again, swap the
+ * pointer readers use, and free the old snapshot once they are done with it.
+ * Entries do not expire from a snapshot.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param out Receives the snapshot; release it with `mac_table_frozen_free()`.
+ *
+ * @return `true` on success, `false` on invalid arguments, an approximate
+ * table, keys wider than 7 bytes or allocation failure.
+ */
+bool mac_table_freeze(const mac_table_t *table, mac_table_frozen_t *out);
+
+/**
+ * @brief Looks up a MAC in a frozen snapshot.
+ *
+ * @param frozen Snapshot built by `mac_table_freeze()`.
+ * @param mac MAC address to look up.
+ * @param role Receives the entry's role (may be NULL).
+ *
+ * @return `MAC_TABLE_OK` if found, `MAC_TABLE_NOT_FOUND` otherwise.
+ */
+mac_entry_result_t mac_table_frozen_lookup(const mac_table_frozen_t *frozen,
+                                           const uint8_t *mac, uint8_t *role);
+
+/**
+ * @brief Membership test against a frozen snapshot.
+ *
+ * @param frozen Snapshot built by `mac_table_freeze()`.
+ * @param mac MAC address to look up.
+ *
+ * @return `MAC_TABLE_OK` if found, `MAC_TABLE_NOT_FOUND` otherwise.
+ */
+mac_entry_result_t mac_table_frozen_exists(const mac_table_frozen_t *frozen,
+                                           const uint8_t *mac);
+
+/**
+ * @brief Releases a frozen snapshot.
+ *
+ * @param frozen Snapshot built by `mac_table_freeze()`.
+ */
+void mac_table_frozen_free(mac_table_frozen_t *frozen);
+
+/**
+ * @brief Copies the MAC address stored in an entry.
+ *
+ * Works in both key layouts; with `MAC_TABLE_OUI_COMPRESSION` the OUI is
+ * looked up in the table's dictionary.
+ *
+ * @param table A pointer to the MAC table the entry belongs to.
+ * @param entry An entry of `table`, or one copied by
+ * `mac_table_get_by_index()`.
+ * @param mac Buffer of `MAC_ADDR_LEN` bytes receiving the address.
+ */
+void mac_table_entry_mac(const mac_table_t *table, const mac_entry_t *entry,
+                         uint8_t *mac);
+
+#ifdef MAC_TABLE_OUI_COMPRESSION
+/**
+ * @brief Makes a table use a caller-owned OUI dictionary.
+ *
+ * Tables built with `MAC_TABLE_OUI_COMPRESSION` start with a private
+ * dictionary. Pointing several tables at the same one saves memory when they
+ * see the same vendors. Only possible while the table is empty.
+ *
+ * @param table A pointer to the MAC table (`mac_table_t`).
+ * @param dict Zero-initialized dictionary, possibly shared with other tables.
+ *
+ * @return `true` on success, `false` if an argument is NULL or the table holds
+ * entries.
+ */
+bool mac_table_share_oui_dict(mac_table_t *table, mac_oui_dict_t *dict);
+#endif
+
 /**
  * @brief Resets the statistics of the MAC table.
  *
@@ -392,7 +1399,7 @@ bool mac_table_get_stats(const mac_table_t *table, mac_table_stats_t *stats);
  * @brief Convert a MAC address to a string format.
  *
  * @param mac Pointer to MAC address bytes.
- * @param str Output buffer to store the string.
+ * @param str Output buffer of at least `MAC_ADDR_STR_LEN` bytes.
  */
 void mac_to_str(const uint8_t *mac, char *str);
 
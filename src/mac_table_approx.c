@@ -0,0 +1,195 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+#include "mac_table.h"
+#include "mac_table_internal.h"
+
+#ifndef M_LN2
+#define M_LN2 0.69314718055994530942
+#endif
+
+#define MAC_APPROX_SEED 0x27D4EB2Fu
+#define MAC_APPROX_MAX_HASHES 16
+
+// Rotating generations of one Bloom filter each
+struct mac_table_approx_t {
+    uint8_t *bits;        // generations * gen_bytes bits, generation-major
+    size_t gen_bits;      // Bits per generation
+    size_t gen_bytes;     // Bytes per generation
+    uint8_t generations;  // Number of generations
+    uint8_t current;      // Generation receiving inserts
+    uint8_t hashes;       // Bits set per MAC
+    time_t period;        // Seconds between rotations
+    time_t rotated;       // Time of the last rotation
+    size_t live[MAC_TABLE_MAX_APPROX_GENERATIONS]; // MACs whose newest copy is in each generation
+};
+
+// Map a 32-bit hash onto [0, gen_bits) without a division
+static inline size_t approx_bit(const mac_table_approx_t *approx, uint32_t hash)
+{
+    return (size_t)(((uint64_t)hash * approx->gen_bits) >> 32);
+}
+
+static bool approx_test(const mac_table_approx_t *approx, uint8_t gen, uint32_t h1, uint32_t h2)
+{
+    const uint8_t *bits = approx->bits + (size_t)gen * approx->gen_bytes;
+    for (uint8_t k = 0; k < approx->hashes; k++) {
+        size_t bit = approx_bit(approx, h1 + k * h2);
+        if (!(bits[bit >> 3] & (1u << (bit & 7)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void approx_set(mac_table_approx_t *approx, uint8_t gen, uint32_t h1, uint32_t h2)
+{
+    uint8_t *bits = approx->bits + (size_t)gen * approx->gen_bytes;
+    for (uint8_t k = 0; k < approx->hashes; k++) {
+        size_t bit = approx_bit(approx, h1 + k * h2);
+        bits[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+    }
+}
+
+// Retire generations whose period has passed; their MACs expire
+static void approx_rotate(const mac_table_t *table, time_t now)
+{
+    mac_table_approx_t *approx = table->approx;
+    if (now - approx->rotated < approx->period) {
+        return;
+    }
+
+    time_t steps = (now - approx->rotated) / approx->period;
+    approx->rotated += steps * approx->period;
+    if (steps > approx->generations) {
+        steps = approx->generations;
+    }
+
+    while (steps-- > 0) {
+        approx->current = (approx->current + 1) % approx->generations;
+        size_t expired = approx->live[approx->current];
+        approx->live[approx->current] = 0;
+        memset(approx->bits + (size_t)approx->current * approx->gen_bytes, 0, approx->gen_bytes);
+
+        table->stats->total_expired += expired;
+        table->stats->active_entries -= expired < table->stats->active_entries ? expired
+                                                                              : table->stats->active_entries;
+    }
+}
+
+mac_table_approx_t *mac_table_approx_create(const mac_table_approx_config_t *config, size_t expiry_seconds)
+{
+    if (!config || config->capacity == 0 || config->generations < 2 ||
+        config->generations > MAC_TABLE_MAX_APPROX_GENERATIONS ||
+        !(config->false_positive_rate > 0.0f && config->false_positive_rate < 1.0f)) {
+        return NULL;
+    }
+
+    // A lookup tests every generation, so split the target rate between them
+    double rate = (double)config->false_positive_rate / config->generations;
+    double bits_per_mac = -log(rate) / (M_LN2 * M_LN2);
+    size_t hashes = (size_t)(bits_per_mac * M_LN2 + 0.5);
+    if (hashes < 1) {
+        hashes = 1;
+    } else if (hashes > MAC_APPROX_MAX_HASHES) {
+        hashes = MAC_APPROX_MAX_HASHES;
+    }
+
+    mac_table_approx_t *approx = (mac_table_approx_t *)calloc(1, sizeof(mac_table_approx_t));
+    if (!approx) {
+        return NULL;
+    }
+
+    approx->gen_bits = (size_t)ceil(bits_per_mac * config->capacity);
+    approx->gen_bytes = (approx->gen_bits + 7) / 8;
+    approx->generations = config->generations;
+    approx->hashes = (uint8_t)hashes;
+    approx->period = (time_t)(expiry_seconds / (config->generations - 1));
+    if (approx->period == 0) {
+        approx->period = 1;
+    }
+    approx->rotated = time(NULL);
+
+    approx->bits = (uint8_t *)calloc(config->generations, approx->gen_bytes);
+    if (!approx->bits) {
+        free(approx);
+        return NULL;
+    }
+    return approx;
+}
+
+mac_entry_result_t mac_table_approx_insert(mac_table_t *table, const uint8_t *mac)
+{
+    mac_table_approx_t *approx = table->approx;
+    approx_rotate(table, time(NULL));
+
+    uint32_t h1 = mac_hash32(mac, MAC_APPROX_SEED);
+    uint32_t h2 = (h1 >> 17 | h1 << 15) | 1;
+
+    // Find the newest generation already holding the MAC
+    mac_entry_result_t result = MAC_TABLE_INSERTED;
+    for (uint8_t age = 0; age < approx->generations; age++) {
+        uint8_t gen = (approx->current + approx->generations - age) % approx->generations;
+        if (!approx_test(approx, gen, h1, h2)) {
+            continue;
+        }
+        if (age == 0) {
+            result = MAC_TABLE_UPDATED;
+            break;
+        }
+        // Refresh: its newest copy moves to the current generation
+        if (approx->live[gen] > 0) {
+            approx->live[gen]--;
+        }
+        approx->live[approx->current]++;
+        approx_set(approx, approx->current, h1, h2);
+        result = MAC_TABLE_UPDATED;
+        break;
+    }
+
+    if (result == MAC_TABLE_INSERTED) {
+        approx_set(approx, approx->current, h1, h2);
+        approx->live[approx->current]++;
+        table->stats->total_inserts++;
+        table->stats->active_entries++;
+    }
+
+    if (table->on_event) {
+        table->on_event(-1, mac, result);
+    }
+    return result;
+}
+
+mac_entry_result_t mac_table_approx_exists(const mac_table_t *table, const uint8_t *mac)
+{
+    const mac_table_approx_t *approx = table->approx;
+    approx_rotate(table, time(NULL));
+
+    uint32_t h1 = mac_hash32(mac, MAC_APPROX_SEED);
+    uint32_t h2 = (h1 >> 17 | h1 << 15) | 1;
+    for (uint8_t gen = 0; gen < approx->generations; gen++) {
+        if (approx_test(approx, gen, h1, h2)) {
+            return MAC_TABLE_OK;
+        }
+    }
+    return MAC_TABLE_NOT_FOUND;
+}
+
+size_t mac_table_approx_clear(mac_table_t *table)
+{
+    mac_table_approx_t *approx = table->approx;
+    size_t cleared = table->stats->active_entries;
+
+    memset(approx->bits, 0, (size_t)approx->generations * approx->gen_bytes);
+    memset(approx->live, 0, sizeof(approx->live));
+    table->stats->total_deletes += cleared;
+    table->stats->active_entries = 0;
+    return cleared;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,13 +3,23 @@ extern "C" {
 #endif
 
 #include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 #include <freertos/timers.h>
 #include "mac_table.h"
+#include "mac_table_internal.h"
+
+// Delay before a timer callback that found the lock held tries again
+#define EXPIRY_LOCK_RETRY_MS 10
 
 // Min-heap entry for tracking expirations
 typedef struct {
+    mac_table_expiry_manager_t *owner; // Manager of the table the slot belongs to
     size_t slot_index;  // Slot index in the MAC table
-    time_t expiry_time; // When the entry expires (timeout_duration)
+    time_t expiry_time; // When this heap entry fires (heap key)
+    time_t deadline;    // Entry's timeout_duration when it was scheduled
+    uint32_t lifetime;  // Seconds granted by the entry's last insert or refresh
+    bool warning;       // Fires the pre-expiry warning rather than the expiry
 } HeapEntry;
 
 // Min-heap structure
@@ -19,17 +29,32 @@ typedef struct {
     size_t capacity;    // Maximum capacity
 } MinHeap;
 
+// Expiry scheduler: one heap and one timer (or worker) serving one or more tables
+struct mac_expiry_scheduler_t {
+    MinHeap *heap;              // Merged min-heap for all registered tables
+    SemaphoreHandle_t lock;     // Recursive mutex guarding the heap against the worker
+    TimerHandle_t expiry_timer; // FreeRTOS timer (NULL once a worker task runs)
+    TaskHandle_t worker_task;   // Dedicated expiry task, NULL in timer mode
+    time_t armed_expiry;        // Deadline the timer or worker is currently armed for
+    uint32_t slack_seconds;     // Wakeups are rounded up to multiples of this (0 = exact)
+    size_t table_count;         // Number of registered tables
+    size_t reserved;            // Sum of the slot counts of registered tables
+};
+
 // Expiry manager structure
 struct mac_table_expiry_manager_t {
-    mac_table_t *table;          // Reference to the MAC table
-    MinHeap *heap;            // Min-heap for expiration times
-    TimerHandle_t expiry_timer; // FreeRTOS timer
+    mac_table_t *table;                // Reference to the MAC table
+    mac_expiry_scheduler_t *scheduler; // Scheduler holding this table's deadlines
+    bool owns_scheduler;               // Private scheduler created with the manager
 };
 
 // Initialize min-heap
 MinHeap *min_heap_create(size_t capacity) {
     MinHeap *heap = pvPortMalloc(sizeof(MinHeap));
     if (!heap) return NULL;
+    if (capacity == 0) {
+        capacity = 1; // pvPortMalloc(0) returns NULL on some ports
+    }
     heap->entries = pvPortMalloc(sizeof(HeapEntry) * capacity);
     if (!heap->entries) {
         vPortFree(heap);
@@ -40,6 +65,22 @@ MinHeap *min_heap_create(size_t capacity) {
     return heap;
 }
 
+// Grow heap capacity, keeping existing entries
+int min_heap_reserve(MinHeap *heap, size_t capacity) {
+    if (capacity <= heap->capacity) {
+        return 0;
+    }
+    HeapEntry *entries = pvPortMalloc(sizeof(HeapEntry) * capacity);
+    if (!entries) {
+        return -1;
+    }
+    memcpy(entries, heap->entries, sizeof(HeapEntry) * heap->size);
+    vPortFree(heap->entries);
+    heap->entries = entries;
+    heap->capacity = capacity;
+    return 0;
+}
+
 // Free min-heap
 void min_heap_free(MinHeap *heap) {
     if (heap) {
@@ -104,21 +145,20 @@ static void heap_bubble_down(MinHeap *heap, size_t index) {
 }
 
 // Insert entry into heap
-int min_heap_insert(MinHeap *heap, size_t slot_index, time_t expiry_time) {
+int min_heap_insert(MinHeap *heap, const HeapEntry *item) {
     if (heap->size >= heap->capacity) {
         return -1; // Heap full
     }
-    heap->entries[heap->size].slot_index = slot_index;
-    heap->entries[heap->size].expiry_time = expiry_time;
+    heap->entries[heap->size] = *item;
     heap_bubble_up(heap, heap->size);
     heap->size++;
     return 0;
 }
 
-// Remove entry from heap by slot_index
-void min_heap_remove(MinHeap *heap, size_t slot_index) {
+// Remove entry from heap by owner and slot_index
+void min_heap_remove(MinHeap *heap, mac_table_expiry_manager_t *owner, size_t slot_index) {
     for (size_t i = 0; i < heap->size; i++) {
-        if (heap->entries[i].slot_index == slot_index) {
+        if (heap->entries[i].owner == owner && heap->entries[i].slot_index == slot_index) {
             heap->entries[i] = heap->entries[heap->size - 1];
             heap->size--;
             if (i < heap->size) {
@@ -130,6 +170,13 @@ void min_heap_remove(MinHeap *heap, size_t slot_index) {
     }
 }
 
+// Restore the heap property after keys were changed in place
+static void min_heap_heapify(MinHeap *heap) {
+    for (size_t i = heap->size / 2; i > 0; i--) {
+        heap_bubble_down(heap, i - 1);
+    }
+}
+
 // Get earliest expiration time
 time_t min_heap_peek(MinHeap *heap) {
     if (heap->size == 0) {
@@ -139,12 +186,11 @@ time_t min_heap_peek(MinHeap *heap) {
 }
 
 // Pop earliest entry
-int min_heap_pop(MinHeap *heap, size_t *slot_index, time_t *expiry_time) {
+int min_heap_pop(MinHeap *heap, HeapEntry *item) {
     if (heap->size == 0) {
         return -1; // Empty heap
     }
-    *slot_index = heap->entries[0].slot_index;
-    *expiry_time = heap->entries[0].expiry_time;
+    *item = heap->entries[0];
     heap->entries[0] = heap->entries[heap->size - 1]; 
     heap->size--;
     if (heap->size > 0) {
@@ -153,116 +199,460 @@ int min_heap_pop(MinHeap *heap, size_t *slot_index, time_t *expiry_time) {
     return 0;
 }
 
-// FreeRTOS timer callback
-static void expiry_timer_callback(TimerHandle_t xTimer) {
-    mac_table_expiry_manager_t *manager = pvTimerGetTimerID(xTimer);
-    MinHeap *heap = manager->heap;
+// Serialize heap access between application tasks and the expiry timer or worker
+static inline void expiry_scheduler_lock(mac_expiry_scheduler_t *scheduler) {
+    xSemaphoreTakeRecursive(scheduler->lock, portMAX_DELAY);
+}
+
+static inline void expiry_scheduler_unlock(mac_expiry_scheduler_t *scheduler) {
+    xSemaphoreGiveRecursive(scheduler->lock);
+}
+
+// Convert an absolute expiry time into a timer/notification delay
+static TickType_t expiry_delay_ticks(time_t next_expiry, time_t now) {
+    return (next_expiry > now) ? pdMS_TO_TICKS((next_expiry - now) * 1000) : 1;
+}
+
+// Insert into the scheduler heap, growing it if the slot reservation fell short
+static bool expiry_scheduler_insert(mac_expiry_scheduler_t *scheduler, const HeapEntry *item) {
+    MinHeap *heap = scheduler->heap;
+    if (min_heap_insert(heap, item) == 0) {
+        return true;
+    }
+    return min_heap_reserve(heap, heap->capacity * 2) == 0 && min_heap_insert(heap, item) == 0;
+}
+
+// Queue a slot for its pre-expiry warning (if configured) or its expiry
+static bool expiry_manager_push(mac_table_expiry_manager_t *manager, size_t slot_index, uint32_t lifetime) {
     mac_table_t *table = manager->table;
+    HeapEntry item = {
+        .owner = manager,
+        .slot_index = slot_index,
+        .expiry_time = table->entries[slot_index].timeout_duration,
+        .deadline = table->entries[slot_index].timeout_duration,
+        .lifetime = lifetime,
+        .warning = false,
+    };
+
+    // With a stale stage, warn ahead of removal rather than ahead of going stale
+    time_t grace = table->expiry_warning_seconds;
+    bool final_stage = table->stale_seconds == 0 || (table->entries[slot_index].flags & MAC_ENTRY_FLAG_STALE);
+    if (grace > 0 && final_stage && item.deadline - grace > time(NULL)) {
+        item.expiry_time = item.deadline - grace;
+        item.warning = true;
+    }
+
+    return expiry_scheduler_insert(manager->scheduler, &item);
+}
+
+// Expire every entry whose deadline has passed, across all registered tables
+static void expiry_scheduler_process(mac_expiry_scheduler_t *scheduler) {
+    MinHeap *heap = scheduler->heap;
     
     time_t now = time(NULL);
     while (heap->size > 0 && min_heap_peek(heap) <= now) {
-        size_t slot_index;
-        time_t expiry_time;
-        if (min_heap_pop(heap, &slot_index, &expiry_time) != 0) {
+        HeapEntry item;
+        if (min_heap_pop(heap, &item) != 0) {
             break;
         }
-        
+
+        mac_table_t *table = item.owner->table;
+        size_t slot_index = item.slot_index;
         if (slot_index < table->size && table->entries[slot_index].state == SLOT_OCCUPIED &&
-            table->entries[slot_index].timeout_duration == expiry_time) {
-                table->stats->total_expired++;
-                table->stats->active_entries--;
+            table->entries[slot_index].timeout_duration == item.deadline) {
+            if (mac_table_extend_on_access(table, slot_index, item.lifetime, now) &&
+                expiry_manager_push(item.owner, slot_index, item.lifetime)) {
+                continue;
+            }
 
-            if (table->on_event) {
-                table->on_event(slot_index, table->entries[slot_index].mac, MAC_TABLE_TIMEOUT);
+            if (item.warning) {
+                // Queue the real expiry before the callback, which may refresh the entry
+                item.expiry_time = item.deadline;
+                item.warning = false;
+                if (!expiry_scheduler_insert(scheduler, &item)) {
+                    // Nowhere to keep the deadline; expire now rather than never
+                    mac_table_release_slot(table, slot_index, MAC_TABLE_TIMEOUT);
+                    continue;
+                }
+                if (table->on_event) {
+                    uint8_t mac[MAC_ADDR_LEN];
+                    mac_table_entry_mac(table, &table->entries[slot_index], mac);
+                    table->on_event(slot_index, mac, MAC_TABLE_EXPIRING);
+                }
+                continue;
             }
 
-            table->entries[slot_index].state = SLOT_TOMBSTONE;
+            if (mac_table_mark_stale(table, slot_index, now) && expiry_manager_push(item.owner, slot_index, item.lifetime)) {
+                if (table->on_event) {
+                    uint8_t mac[MAC_ADDR_LEN];
+                    mac_table_entry_mac(table, &table->entries[slot_index], mac);
+                    table->on_event(slot_index, mac, MAC_TABLE_STALE);
+                }
+                continue;
+            }
+
+            mac_table_release_slot(table, slot_index, MAC_TABLE_TIMEOUT);
         }
     }
+}
+
+// Next wakeup time: the earliest deadline rounded up to a slack bucket boundary,
+// so that every deadline inside the bucket is handled by the same wakeup
+static time_t expiry_scheduler_next_wakeup(mac_expiry_scheduler_t *scheduler) {
+    time_t next_expiry = min_heap_peek(scheduler->heap);
+    time_t slack = scheduler->slack_seconds;
+    if (next_expiry == 0 || slack <= 1) {
+        return next_expiry;
+    }
+    return ((next_expiry + slack - 1) / slack) * slack;
+}
+
+// Re-arm the timer, or wake the worker, after the earliest deadline may have moved
+static void expiry_scheduler_reschedule(mac_expiry_scheduler_t *scheduler) {
+    time_t next_expiry = expiry_scheduler_next_wakeup(scheduler);
+
+    if (scheduler->worker_task) {
+        if (next_expiry != scheduler->armed_expiry) {
+            xTaskNotifyGive(scheduler->worker_task);
+        }
+        return;
+    }
+
+    if (next_expiry == 0) {
+        xTimerStop(scheduler->expiry_timer, 0);
+        scheduler->armed_expiry = 0;
+        return;
+    }
+    if (next_expiry == scheduler->armed_expiry && xTimerIsTimerActive(scheduler->expiry_timer) != pdFALSE) {
+        return; // Already armed for this deadline
+    }
+
+    TickType_t ticks = expiry_delay_ticks(next_expiry, time(NULL));
+    xTimerChangePeriod(scheduler->expiry_timer, ticks, 0);
+    xTimerStart(scheduler->expiry_timer, 0);
+    scheduler->armed_expiry = next_expiry;
+}
+
+// FreeRTOS timer callback
+static void expiry_timer_callback(TimerHandle_t xTimer) {
+    mac_expiry_scheduler_t *scheduler = pvTimerGetTimerID(xTimer);
+
+    // Timer callbacks must not block the timer service task; if a task holds
+    // the lock, try again shortly
+    if (xSemaphoreTakeRecursive(scheduler->lock, 0) != pdTRUE) {
+        xTimerChangePeriod(xTimer, pdMS_TO_TICKS(EXPIRY_LOCK_RETRY_MS), 0);
+        xTimerStart(xTimer, 0);
+        return;
+    }
+    expiry_scheduler_process(scheduler);
     
     // Restart timer for next expiration
-    if (heap->size > 0) {
-        time_t next_expiry = min_heap_peek(heap);
-        time_t now = time(NULL);
-        TickType_t ticks = (next_expiry > now) ? pdMS_TO_TICKS((next_expiry - now) * 1000) : 1;
-        xTimerChangePeriod(xTimer, ticks, 0);
-        xTimerStart(xTimer, 0);
+    expiry_scheduler_reschedule(scheduler);
+    expiry_scheduler_unlock(scheduler);
+}
+
+// Dedicated expiry task: sleeps until the next deadline or a notification
+static void expiry_worker_task(void *arg) {
+    mac_expiry_scheduler_t *scheduler = arg;
+
+    for (;;) {
+        TickType_t wait = portMAX_DELAY;
+        expiry_scheduler_lock(scheduler);
+        scheduler->armed_expiry = expiry_scheduler_next_wakeup(scheduler);
+        if (scheduler->armed_expiry > 0) {
+            wait = expiry_delay_ticks(scheduler->armed_expiry, time(NULL));
+        }
+        expiry_scheduler_unlock(scheduler);
+
+        ulTaskNotifyTake(pdTRUE, wait);
+        expiry_scheduler_lock(scheduler);
+        expiry_scheduler_process(scheduler);
+        expiry_scheduler_unlock(scheduler);
     }
 }
 
-// Initialize expiry manager
-mac_table_expiry_manager_t *expiry_manager_create(mac_table_t *table) {
+// Create a scheduler with room for `capacity` pending deadlines
+mac_expiry_scheduler_t *mac_expiry_scheduler_create(size_t capacity) {
+    mac_expiry_scheduler_t *scheduler = pvPortMalloc(sizeof(mac_expiry_scheduler_t));
+    if (!scheduler) return NULL;
+
+    scheduler->worker_task = NULL;
+    scheduler->armed_expiry = 0;
+    scheduler->table_count = 0;
+    scheduler->slack_seconds = 0;
+    scheduler->reserved = 0;
+    scheduler->heap = min_heap_create(capacity);
+    if (!scheduler->heap) {
+        vPortFree(scheduler);
+        return NULL;
+    }
+
+    scheduler->lock = xSemaphoreCreateRecursiveMutex();
+    if (!scheduler->lock) {
+        min_heap_free(scheduler->heap);
+        vPortFree(scheduler);
+        return NULL;
+    }
+
+    scheduler->expiry_timer = xTimerCreate("ExpiryTimer", pdMS_TO_TICKS(1000), pdFALSE, scheduler, expiry_timer_callback);
+    if (!scheduler->expiry_timer) {
+        vSemaphoreDelete(scheduler->lock);
+        min_heap_free(scheduler->heap);
+        vPortFree(scheduler);
+        return NULL;
+    }
+
+    return scheduler;
+}
+
+// Free a scheduler; all tables must have been detached
+void mac_expiry_scheduler_free(mac_expiry_scheduler_t *scheduler) {
+    if (scheduler) {
+        if (scheduler->worker_task) {
+            vTaskDelete(scheduler->worker_task);
+        }
+        if (scheduler->expiry_timer) {
+            xTimerStop(scheduler->expiry_timer, 0);
+            xTimerDelete(scheduler->expiry_timer, 0);
+        }
+        vSemaphoreDelete(scheduler->lock);
+        min_heap_free(scheduler->heap);
+        vPortFree(scheduler);
+    }
+}
+
+// Exchange the slot indexes of two entries' pending deadlines after they trade places
+void expiry_manager_swap_slots(mac_table_expiry_manager_t *manager, size_t a, size_t b) {
+    if (!manager || a == b) return;
+
+    // Heap order depends only on deadlines, so relabeling keeps it valid
+    MinHeap *heap = manager->scheduler->heap;
+    expiry_scheduler_lock(manager->scheduler);
+    for (size_t i = 0; i < heap->size; i++) {
+        HeapEntry *item = &heap->entries[i];
+        if (item->owner != manager) continue;
+
+        if (item->slot_index == a) {
+            item->slot_index = b;
+        } else if (item->slot_index == b) {
+            item->slot_index = a;
+        }
+    }
+    expiry_scheduler_unlock(manager->scheduler);
+}
+
+// Shorten (or stretch) the remaining lifetime of a table's pending entries
+void expiry_manager_scale_remaining(mac_table_expiry_manager_t *manager, uint32_t num, uint32_t den) {
+    if (!manager || den == 0) return;
+
+    mac_table_t *table = manager->table;
+    MinHeap *heap = manager->scheduler->heap;
+    time_t now = time(NULL);
+
+    expiry_scheduler_lock(manager->scheduler);
+    for (size_t i = 0; i < heap->size; i++) {
+        HeapEntry *item = &heap->entries[i];
+        if (item->owner != manager || item->deadline <= now) continue;
+
+        mac_entry_t *entry = &table->entries[item->slot_index];
+        if (entry->state != SLOT_OCCUPIED || entry->timeout_duration != item->deadline) continue;
+
+        time_t remaining = (item->deadline - now) * num / den;
+        time_t deadline = now + (remaining > 0 ? remaining : 1);
+        uint32_t lifetime = (uint64_t)item->lifetime * num / den;
+        item->lifetime = lifetime > 0 ? lifetime : 1;
+        if (item->warning) {
+            // Keep the same warning lead time; a due warning fires on the next wakeup
+            item->expiry_time -= item->deadline - deadline;
+        } else {
+            item->expiry_time = deadline;
+        }
+        item->deadline = deadline;
+        entry->timeout_duration = deadline;
+    }
+
+    min_heap_heapify(heap);
+    expiry_scheduler_reschedule(manager->scheduler);
+    expiry_scheduler_unlock(manager->scheduler);
+}
+
+// Move expiry processing from the timer service task to a dedicated task
+bool mac_expiry_scheduler_start_worker(mac_expiry_scheduler_t *scheduler,
+                                       const mac_table_expiry_worker_config_t *config) {
+    if (!scheduler || !config) {
+        return false;
+    }
+    if (scheduler->worker_task) {
+        return false; // Already running
+    }
+
+    uint32_t stack_size = config->stack_size ? config->stack_size : MAC_TABLE_EXPIRY_WORKER_STACK;
+    TaskHandle_t task = NULL;
+#ifdef ESP_PLATFORM
+    BaseType_t core = (config->core_id == MAC_TABLE_NO_AFFINITY) ? tskNO_AFFINITY : config->core_id;
+    BaseType_t created = xTaskCreatePinnedToCore(expiry_worker_task, "ExpiryWorker", stack_size, scheduler,
+                                                 config->priority, &task, core);
+#else
+    BaseType_t created = xTaskCreate(expiry_worker_task, "ExpiryWorker", stack_size, scheduler,
+                                     config->priority, &task);
+#endif
+    if (created != pdPASS) {
+        return false;
+    }
+
+    // The task now owns all deadlines; retire the shared timer
+    expiry_scheduler_lock(scheduler);
+    xTimerStop(scheduler->expiry_timer, 0);
+    xTimerDelete(scheduler->expiry_timer, 0);
+    scheduler->expiry_timer = NULL;
+    scheduler->worker_task = task;
+    xTaskNotifyGive(task);
+    expiry_scheduler_unlock(scheduler);
+
+    return true;
+}
+
+// Coalesce deadlines into slack-sized buckets
+bool mac_expiry_scheduler_set_slack(mac_expiry_scheduler_t *scheduler, uint32_t slack_seconds) {
+    if (!scheduler) {
+        return false;
+    }
+    expiry_scheduler_lock(scheduler);
+    scheduler->slack_seconds = slack_seconds;
+    expiry_scheduler_reschedule(scheduler);
+    expiry_scheduler_unlock(scheduler);
+    return true;
+}
+
+bool mac_table_set_expiry_slack(mac_table_t *table, uint32_t slack_seconds) {
+    if (!table || !table->expiry_manager) {
+        return false;
+    }
+    return mac_expiry_scheduler_set_slack(table->expiry_manager->scheduler, slack_seconds);
+}
+
+bool mac_table_start_expiry_worker(mac_table_t *table, const mac_table_expiry_worker_config_t *config) {
+    if (!table || !table->expiry_manager) {
+        return false;
+    }
+    return mac_expiry_scheduler_start_worker(table->expiry_manager->scheduler, config);
+}
+
+// Initialize expiry manager on a shared scheduler
+mac_table_expiry_manager_t *expiry_manager_create_shared(mac_table_t *table, mac_expiry_scheduler_t *scheduler) {
+    if (!table || !scheduler) return NULL;
+
     mac_table_expiry_manager_t *manager = pvPortMalloc(sizeof(mac_table_expiry_manager_t));
     if (!manager) return NULL;
-    
-    manager->table = table;
-    manager->heap = min_heap_create(table->size);
-    if (!manager->heap) {
+
+    // Every registered table may have all of its slots pending at once
+    expiry_scheduler_lock(scheduler);
+    if (min_heap_reserve(scheduler->heap, scheduler->reserved + table->size) != 0) {
+        expiry_scheduler_unlock(scheduler);
         vPortFree(manager);
         return NULL;
     }
-    
-    manager->expiry_timer = xTimerCreate("ExpiryTimer", pdMS_TO_TICKS(1000), pdFALSE, manager, expiry_timer_callback);
-    if (!manager->expiry_timer) {
-        min_heap_free(manager->heap);
-        vPortFree(manager);
+
+    manager->table = table;
+    manager->scheduler = scheduler;
+    manager->owns_scheduler = false;
+    scheduler->table_count++;
+    scheduler->reserved += table->size;
+    expiry_scheduler_unlock(scheduler);
+
+    return manager;
+}
+
+// Initialize expiry manager with a private scheduler
+mac_table_expiry_manager_t *expiry_manager_create(mac_table_t *table) {
+    mac_expiry_scheduler_t *scheduler = mac_expiry_scheduler_create(table->size);
+    if (!scheduler) return NULL;
+
+    mac_table_expiry_manager_t *manager = expiry_manager_create_shared(table, scheduler);
+    if (!manager) {
+        mac_expiry_scheduler_free(scheduler);
         return NULL;
     }
+    manager->owns_scheduler = true;
     
     return manager;
 }
 
-// Free expiry manager
+// Free expiry manager, dropping its pending deadlines from the scheduler
 void expiry_manager_free(mac_table_expiry_manager_t *manager) {
     if (manager) {
-        if (manager->expiry_timer) {
-            xTimerStop(manager->expiry_timer, 0);
-            xTimerDelete(manager->expiry_timer, 0);
+        mac_expiry_scheduler_t *scheduler = manager->scheduler;
+        MinHeap *heap = scheduler->heap;
+        expiry_scheduler_lock(scheduler);
+        // Filter in one pass: removing entries one by one lets the refill move
+        // a not yet visited entry behind the scan
+        size_t kept = 0;
+        for (size_t i = 0; i < heap->size; i++) {
+            if (heap->entries[i].owner != manager) {
+                heap->entries[kept++] = heap->entries[i];
+            }
+        }
+        heap->size = kept;
+        min_heap_heapify(heap);
+        scheduler->table_count--;
+        scheduler->reserved -= manager->table->size;
+        if (!manager->owns_scheduler) {
+            expiry_scheduler_reschedule(scheduler);
+        }
+        expiry_scheduler_unlock(scheduler);
+
+        if (manager->owns_scheduler) {
+            mac_expiry_scheduler_free(scheduler);
         }
-        min_heap_free(manager->heap);
         vPortFree(manager);
     }
 }
 
-// Notify manager of entry addition or update
-void expiry_manager_add_or_update(mac_table_expiry_manager_t *manager, size_t slot_index) {
-    if (!manager || slot_index >= manager->table->size) return;
+// Queue a slot's deadline, remembering the lifetime a sliding extension grants
+bool expiry_manager_schedule(mac_table_expiry_manager_t *manager, size_t slot_index, time_t lifetime) {
+    if (!manager || slot_index >= manager->table->size) return false;
     
     mac_entry_t *entry = &manager->table->entries[slot_index];
-    if (entry->state != SLOT_OCCUPIED) return;
+    if (entry->state != SLOT_OCCUPIED) return false;
+
+    MinHeap *heap = manager->scheduler->heap;
+    expiry_scheduler_lock(manager->scheduler);
     
     // Remove existing entry for this slot
-    min_heap_remove(manager->heap, slot_index);
+    min_heap_remove(heap, manager, slot_index);
     
     // Add new expiration time
-    time_t expiry_time = entry->timeout_duration;
-    min_heap_insert(manager->heap, slot_index, expiry_time);
+    if (lifetime < 1) {
+        lifetime = 1;
+    } else if (lifetime > UINT32_MAX) {
+        lifetime = UINT32_MAX;
+    }
+    bool queued = expiry_manager_push(manager, slot_index, (uint32_t)lifetime);
     
     // Update timer
-    time_t now = time(NULL);
-    time_t next_expiry = min_heap_peek(manager->heap);
-    if (next_expiry > 0 && (xTimerIsTimerActive(manager->expiry_timer) == pdFALSE || next_expiry <= now)) {
-        TickType_t ticks = (next_expiry > now) ? pdMS_TO_TICKS((next_expiry - now) * 1000) : 1;
-        xTimerChangePeriod(manager->expiry_timer, ticks, 0);
-        xTimerStart(manager->expiry_timer, 0);
-    }
+    expiry_scheduler_reschedule(manager->scheduler);
+    expiry_scheduler_unlock(manager->scheduler);
+    return queued;
+}
+
+// Notify manager of entry addition or update
+bool expiry_manager_add_or_update(mac_table_expiry_manager_t *manager, size_t slot_index) {
+    if (!manager || slot_index >= manager->table->size) return false;
+
+    // Without a known lifetime, take what is left of the current one
+    time_t lifetime = manager->table->entries[slot_index].timeout_duration - time(NULL);
+    return expiry_manager_schedule(manager, slot_index, lifetime);
 }
 
 // Notify manager of entry deletion
 void expiry_manager_delete(mac_table_expiry_manager_t *manager, size_t slot_index) {
     if (!manager || slot_index >= manager->table->size) return;
-    min_heap_remove(manager->heap, slot_index);
+    expiry_scheduler_lock(manager->scheduler);
+    min_heap_remove(manager->scheduler->heap, manager, slot_index);
     
-    // Update timer if heap is not empty
-    if (manager->heap->size > 0) {
-        time_t now = time(NULL);
-        time_t next_expiry = min_heap_peek(manager->heap);
-        TickType_t ticks = (next_expiry > now) ? pdMS_TO_TICKS((next_expiry - now) * 1000) : 1;
-        xTimerChangePeriod(manager->expiry_timer, ticks, 0);
-        xTimerStart(manager->expiry_timer, 0);
-    } else {
-        xTimerStop(manager->expiry_timer, 0);
-    }
+    // Update timer (stops it if the heap is empty)
+    expiry_scheduler_reschedule(manager->scheduler);
+    expiry_scheduler_unlock(manager->scheduler);
 }
 
 static bool is_protected_role(uint8_t role, const uint8_t *protected_roles) {
@@ -273,13 +663,18 @@ static bool is_protected_role(uint8_t role, const uint8_t *protected_roles) {
 }
 
 bool mac_table_remove_oldest(mac_table_t *table, const uint8_t *protected_roles) {
-    if (!table || !table->expiry_manager || table->expiry_manager->heap->size == 0) {
+    if (!table || !table->expiry_manager) {
         return false;
     }
 
-    MinHeap *heap = table->expiry_manager->heap;
+    mac_expiry_scheduler_t *scheduler = table->expiry_manager->scheduler;
+    MinHeap *heap = scheduler->heap;
+    bool removed = false;
 
+    expiry_scheduler_lock(scheduler);
     for (size_t i = 0; i < heap->size; ++i) {
+        if (heap->entries[i].owner != table->expiry_manager) continue;
+
         size_t index = heap->entries[i].slot_index;
 
         if (index >= table->size) continue;
@@ -291,20 +686,25 @@ bool mac_table_remove_oldest(mac_table_t *table, const uint8_t *protected_roles)
             continue;  
         }
 
-        entry->state = SLOT_TOMBSTONE;
-        table->stats->total_deletes++;
-        table->stats->active_entries--;
-
-        expiry_manager_delete(table->expiry_manager, index);
+        mac_table_release_slot(table, index, MAC_TABLE_DELETED);
+        removed = true;
+        break;
+    }
+    expiry_scheduler_unlock(scheduler);
 
-        if (table->on_event) {
-            table->on_event(index, entry->mac, MAC_TABLE_DELETED);
-        }
+    return removed;
+}
 
-        return true;
+void mac_table_lock(mac_table_t *table) {
+    if (table && table->expiry_manager) {
+        expiry_scheduler_lock(table->expiry_manager->scheduler);
     }
+}
 
-    return false;
+void mac_table_unlock(mac_table_t *table) {
+    if (table && table->expiry_manager) {
+        expiry_scheduler_unlock(table->expiry_manager->scheduler);
+    }
 }
 
 #ifdef __cplusplus
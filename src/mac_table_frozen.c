@@ -0,0 +1,113 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdlib.h>
+#include "mac_table.h"
+#include "mac_table_internal.h"
+
+/* Frozen records pack the key above its 8-bit role, so ordering the
+ * records orders the MACs and a lookup touches one 64-bit word per level. */
+#define MAC_FROZEN_ROLE_BITS 8
+#define MAC_FROZEN_SUPPORTED (MAC_ADDR_LEN * 8 + MAC_FROZEN_ROLE_BITS <= 64)
+
+static int mac_frozen_compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// In-order walk of the implicit tree rooted at `node`, taking sorted records in turn
+static size_t mac_frozen_layout(uint64_t *tree, size_t count, const uint64_t *sorted, size_t next, size_t node)
+{
+    if (node <= count) {
+        next = mac_frozen_layout(tree, count, sorted, next, 2 * node);
+        tree[node] = sorted[next++];
+        next = mac_frozen_layout(tree, count, sorted, next, 2 * node + 1);
+    }
+    return next;
+}
+
+bool mac_table_freeze(const mac_table_t *table, mac_table_frozen_t *out)
+{
+    if (!MAC_FROZEN_SUPPORTED || !table || !out || table->approx) {
+        return false;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < table->size; i++) {
+        count += table->entries[i].state == SLOT_OCCUPIED;
+    }
+
+    uint64_t *sorted = (uint64_t *)malloc((count ? count : 1) * sizeof(uint64_t));
+    uint64_t *tree = (uint64_t *)malloc((count + 1) * sizeof(uint64_t));
+    if (!sorted || !tree) {
+        free(sorted);
+        free(tree);
+        return false;
+    }
+
+    size_t n = 0;
+    for (size_t i = 0; i < table->size; i++) {
+        const mac_entry_t *entry = &table->entries[i];
+        if (entry->state == SLOT_OCCUPIED) {
+            uint8_t mac[MAC_ADDR_LEN];
+            mac_table_entry_mac(table, entry, mac);
+            sorted[n++] = mac_key_to_u64(mac) << MAC_FROZEN_ROLE_BITS | entry->role;
+        }
+    }
+    qsort(sorted, count, sizeof(uint64_t), mac_frozen_compare);
+
+    // Eytzinger (breadth-first) order: the first levels share cache lines
+    tree[0] = 0;
+    mac_frozen_layout(tree, count, sorted, 0, 1);
+    free(sorted);
+
+    out->records = tree;
+    out->count = count;
+    return true;
+}
+
+mac_entry_result_t mac_table_frozen_lookup(const mac_table_frozen_t *frozen, const uint8_t *mac, uint8_t *role)
+{
+    if (!frozen || !frozen->records || !mac) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+
+    // Branch-free descent to the first record >= (mac, role 0)
+    uint64_t key = mac_key_to_u64(mac);
+    uint64_t target = key << MAC_FROZEN_ROLE_BITS;
+    size_t node = 1;
+    while (node <= frozen->count) {
+        node = 2 * node + (frozen->records[node] < target);
+    }
+    node >>= __builtin_ffsll(~(long long)node);
+
+    if (node == 0 || frozen->records[node] >> MAC_FROZEN_ROLE_BITS != key) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+    if (role) {
+        *role = (uint8_t)frozen->records[node];
+    }
+    return MAC_TABLE_OK;
+}
+
+mac_entry_result_t mac_table_frozen_exists(const mac_table_frozen_t *frozen, const uint8_t *mac)
+{
+    return mac_table_frozen_lookup(frozen, mac, NULL);
+}
+
+void mac_table_frozen_free(mac_table_frozen_t *frozen)
+{
+    if (!frozen) {
+        return;
+    }
+    free(frozen->records);
+    frozen->records = NULL;
+    frozen->count = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
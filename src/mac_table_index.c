@@ -0,0 +1,167 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "mac_table.h"
+#include "mac_table_internal.h"
+
+/* Index records pack the key above a 16-bit slot number, so sorting the
+ * records sorts by MAC and one record fits a single 64-bit compare. */
+#define MAC_INDEX_SLOT_BITS 16
+#define MAC_INDEX_SLOT_MASK ((1u << MAC_INDEX_SLOT_BITS) - 1)
+#define MAC_INDEX_KEY_BITS (MAC_ADDR_LEN * 8)
+#define MAC_INDEX_SUPPORTED (MAC_INDEX_KEY_BITS + MAC_INDEX_SLOT_BITS <= 64)
+#if MAC_INDEX_SUPPORTED
+#define MAC_INDEX_KEY_MAX (((uint64_t)1 << MAC_INDEX_KEY_BITS) - 1)
+#define MAC_INDEX_OUI_SHIFT (MAC_INDEX_KEY_BITS - 24) // OUI is the first three bytes of the key
+#else
+#define MAC_INDEX_KEY_MAX UINT64_MAX
+#define MAC_INDEX_OUI_SHIFT 0
+#endif
+
+static inline uint64_t mac_index_record(uint64_t key, size_t slot)
+{
+    return key << MAC_INDEX_SLOT_BITS | slot;
+}
+
+static inline size_t mac_index_slot(uint64_t record)
+{
+    return (size_t)(record & MAC_INDEX_SLOT_MASK);
+}
+
+// First record at or above `record`
+static size_t mac_index_lower_bound(const mac_table_t *table, uint64_t record)
+{
+    size_t lo = 0;
+    size_t hi = table->index_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (table->index[mid] < record) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Copy slots of records whose key lies in [lo_key, hi_key]
+static size_t mac_index_collect(const mac_table_t *table, uint64_t lo_key, uint64_t hi_key, size_t *slots,
+                                size_t max)
+{
+    size_t n = 0;
+    for (size_t i = mac_index_lower_bound(table, mac_index_record(lo_key, 0));
+         i < table->index_count && n < max && (table->index[i] >> MAC_INDEX_SLOT_BITS) <= hi_key; i++) {
+        slots[n++] = mac_index_slot(table->index[i]);
+    }
+    return n;
+}
+
+void mac_table_index_add(mac_table_t *table, const uint8_t *mac, size_t slot)
+{
+    if (!table->index) {
+        return;
+    }
+
+    uint64_t record = mac_index_record(mac_key_to_u64(mac), slot);
+    size_t pos = mac_index_lower_bound(table, record);
+    memmove(&table->index[pos + 1], &table->index[pos], (table->index_count - pos) * sizeof(uint64_t));
+    table->index[pos] = record;
+    table->index_count++;
+}
+
+void mac_table_index_remove(mac_table_t *table, const uint8_t *mac, size_t slot)
+{
+    if (!table->index) {
+        return;
+    }
+
+    uint64_t record = mac_index_record(mac_key_to_u64(mac), slot);
+    size_t pos = mac_index_lower_bound(table, record);
+    if (pos < table->index_count && table->index[pos] == record) {
+        table->index_count--;
+        memmove(&table->index[pos], &table->index[pos + 1], (table->index_count - pos) * sizeof(uint64_t));
+    }
+}
+
+void mac_table_index_move(mac_table_t *table, const uint8_t *mac, size_t from, size_t to)
+{
+    if (!table->index) {
+        return;
+    }
+
+    // Same MAC, so the record keeps its position
+    uint64_t key = mac_key_to_u64(mac);
+    size_t pos = mac_index_lower_bound(table, mac_index_record(key, from));
+    if (pos < table->index_count && table->index[pos] == mac_index_record(key, from)) {
+        table->index[pos] = mac_index_record(key, to);
+    }
+}
+
+bool mac_table_enable_ordered_index(mac_table_t *table, uint64_t *records)
+{
+    if (!table || table->approx) {
+        return false;
+    }
+    if (!records) {
+        table->index = NULL;
+        table->index_count = 0;
+        return true;
+    }
+    if (!MAC_INDEX_SUPPORTED || table->size > MAC_INDEX_SLOT_MASK + 1) {
+        return false;
+    }
+
+    table->index = records;
+    table->index_count = 0;
+    for (size_t i = 0; i < table->size; i++) {
+        if (table->entries[i].state == SLOT_OCCUPIED) {
+            uint8_t mac[MAC_ADDR_LEN];
+            mac_table_entry_mac(table, &table->entries[i], mac);
+            mac_table_index_add(table, mac, i);
+        }
+    }
+    return true;
+}
+
+size_t mac_table_find_by_oui(const mac_table_t *table, const uint8_t *oui, size_t *slots, size_t max)
+{
+    if (!table || !table->index || !oui || !slots) {
+        return 0;
+    }
+
+    uint64_t rest = ((uint64_t)1 << MAC_INDEX_OUI_SHIFT) - 1;
+    uint64_t prefix = ((uint64_t)oui[0] << 16 | (uint64_t)oui[1] << 8 | oui[2]) << MAC_INDEX_OUI_SHIFT;
+    return mac_index_collect(table, prefix, prefix | rest, slots, max);
+}
+
+size_t mac_table_find_range(const mac_table_t *table, const uint8_t *first, const uint8_t *last, size_t *slots,
+                            size_t max)
+{
+    if (!table || !table->index || !first || !last || !slots) {
+        return 0;
+    }
+
+    return mac_index_collect(table, mac_key_to_u64(first), mac_key_to_u64(last), slots, max);
+}
+
+int mac_table_find_next(const mac_table_t *table, const uint8_t *mac)
+{
+    if (!table || !table->index) {
+        return -1;
+    }
+
+    size_t pos = 0;
+    if (mac) {
+        uint64_t key = mac_key_to_u64(mac);
+        if (key == MAC_INDEX_KEY_MAX) {
+            return -1;
+        }
+        pos = mac_index_lower_bound(table, mac_index_record(key + 1, 0));
+    }
+    return pos < table->index_count ? (int)mac_index_slot(table->index[pos]) : -1;
+}
+
+#ifdef __cplusplus
+}
+#endif
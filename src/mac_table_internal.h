@@ -0,0 +1,236 @@
+/**
+ * @file mac_table_internal.h
+ * @brief Helpers shared between the MAC table sources. Not part of the public
+ * API.
+ */
+
+#ifndef MAC_TABLE_INTERNAL_H
+#define MAC_TABLE_INTERNAL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef ESP_PLATFORM
+#include <esp_crc.h>
+#endif
+#include "mac_table.h"
+
+/**
+ * @brief Seeded 32-bit hash of a MAC address.
+ *
+ * Uses the ROM CRC32 on ESP targets and FNV-1a elsewhere. Different seeds give
+ * independent hashes for the probe start, jitter, filters and sketches.
+ */
+static inline uint32_t mac_hash32(const uint8_t *mac, uint32_t seed)
+{
+#ifdef ESP_PLATFORM
+    return esp_crc32_le(seed, mac, MAC_ADDR_LEN);
+#else
+    uint32_t hash = 0x811C9DC5 ^ seed;
+    for (size_t i = 0; i < MAC_ADDR_LEN; ++i) {
+        hash ^= mac[i];
+        hash *= 0x01000193;
+    }
+    return hash;
+#endif
+}
+
+/**
+ * @brief Key equality, specialized on `MAC_ADDR_LEN`.
+ *
+ * The common widths load the keys as integers (memcpy keeps it safe for
+ * unaligned keys and compiles to plain loads); other widths use memcmp.
+ */
+static inline bool mac_key_equal(const uint8_t *a, const uint8_t *b)
+{
+#if MAC_ADDR_LEN == 4
+    uint32_t x, y;
+    memcpy(&x, a, 4);
+    memcpy(&y, b, 4);
+    return x == y;
+#elif MAC_ADDR_LEN == 6
+    uint32_t x_hi, y_hi;
+    uint16_t x_lo, y_lo;
+    memcpy(&x_hi, a, 4);
+    memcpy(&y_hi, b, 4);
+    memcpy(&x_lo, a + 4, 2);
+    memcpy(&y_lo, b + 4, 2);
+    return ((x_hi ^ y_hi) | (uint32_t)(x_lo ^ y_lo)) == 0;
+#elif MAC_ADDR_LEN == 8
+    uint64_t x, y;
+    memcpy(&x, a, 8);
+    memcpy(&y, b, 8);
+    return x == y;
+#else
+    return memcmp(a, b, MAC_ADDR_LEN) == 0;
+#endif
+}
+
+/**
+ * @brief MAC as a big-endian integer, so integer order is address order.
+ *
+ * Only meaningful for keys of at most 8 bytes.
+ */
+static inline uint64_t mac_key_to_u64(const uint8_t *mac)
+{
+    uint64_t key = 0;
+    for (size_t i = 0; i < MAC_ADDR_LEN; i++) {
+        key = key << 8 | mac[i];
+    }
+    return key;
+}
+
+/**
+ * @brief Remove an occupied slot from the table.
+ *
+ * Tombstones the slot, updates statistics and occupancy-driven policies, drops
+ * the slot from the expiry manager (unless it is being expired, in which case
+ * the manager has already popped it) and fires `on_event` with `reason`.
+ *
+ * @param table Pointer to the MAC table.
+ * @param slot Index of an occupied slot.
+ * @param reason `MAC_TABLE_DELETED` or `MAC_TABLE_TIMEOUT`.
+ */
+void mac_table_release_slot(mac_table_t *table, size_t slot,
+                            mac_entry_result_t reason);
+
+/**
+ * @brief Re-evaluate occupancy-driven policies after `active_entries`
+ * changed.
+ *
+ * @param table Pointer to the MAC table.
+ * @param mac MAC whose insertion or removal changed occupancy, passed to
+ * watermark events (may be NULL).
+ */
+void mac_table_update_pressure(mac_table_t *table, const uint8_t *mac);
+
+/**
+ * @brief Push back the deadline of a due entry that was looked up recently.
+ *
+ * With sliding expiry enabled, a lookup hit only stamps `last_access`. When
+ * the entry reaches the top of the expiry heap, this moves its
+ * `timeout_duration` to `last_access` plus `lifetime` if that is still in the
+ * future, and clears `last_access` so the hit is not credited twice.
+ *
+ * @param table Pointer to the MAC table.
+ * @param slot Index of an occupied slot that came due.
+ * @param lifetime Seconds the entry's last insert or refresh granted.
+ * @param now Current time.
+ * @return true if the deadline was extended and the entry must be
+ * rescheduled, false otherwise.
+ */
+bool mac_table_extend_on_access(mac_table_t *table, size_t slot,
+                                time_t lifetime, time_t now);
+
+/**
+ * @brief Queue an occupied slot's deadline in the expiry manager.
+ *
+ * Like `expiry_manager_add_or_update()`, but records the lifetime the insert
+ * or refresh granted, which sliding expiry later grants again from the last
+ * lookup hit.
+ *
+ * @param manager Pointer to the expiry manager.
+ * @param slot_index Index of the slot to add or update.
+ * @param lifetime Seconds granted, normally `timeout_duration - now`.
+ * @return true if the slot's deadline is queued, false on invalid arguments
+ * or when the deadline heap could not grow.
+ */
+bool expiry_manager_schedule(mac_table_expiry_manager_t *manager,
+                             size_t slot_index, time_t lifetime);
+
+/**
+ * @brief Move a due entry to the stale stage.
+ *
+ * With a stale timeout configured, an active entry whose deadline passed is
+ * flagged `MAC_ENTRY_FLAG_STALE` and given `stale_seconds` more before it is
+ * removed.
+ *
+ * @param table Pointer to the MAC table.
+ * @param slot Index of an occupied slot whose deadline has passed.
+ * @param now Current time.
+ * @return true if the entry became stale and must be rescheduled, false if it
+ * should be removed.
+ */
+bool mac_table_mark_stale(mac_table_t *table, size_t slot, time_t now);
+
+/**
+ * @brief Scale the remaining lifetime of every pending entry of a table.
+ *
+ * Each deadline in the future becomes `now + remaining * num / den`.
+ *
+ * @param manager Pointer to the expiry manager.
+ * @param num Scale numerator.
+ * @param den Scale denominator.
+ */
+void expiry_manager_scale_remaining(mac_table_expiry_manager_t *manager,
+                                    uint32_t num, uint32_t den);
+
+/**
+ * @brief Relabel a table's pending deadlines after two slots were swapped.
+ *
+ * @param manager Pointer to the expiry manager.
+ * @param a First slot index.
+ * @param b Second slot index.
+ */
+void expiry_manager_swap_slots(mac_table_expiry_manager_t *manager, size_t a,
+                               size_t b);
+
+/**
+ * @brief Add an occupied slot to the ordered index (no-op when disabled).
+ */
+void mac_table_index_add(mac_table_t *table, const uint8_t *mac, size_t slot);
+
+/**
+ * @brief Remove a slot that is being vacated from the ordered index.
+ */
+void mac_table_index_remove(mac_table_t *table, const uint8_t *mac,
+                            size_t slot);
+
+/**
+ * @brief Point the index record of `mac` at the slot it was moved to.
+ */
+void mac_table_index_move(mac_table_t *table, const uint8_t *mac, size_t from,
+                          size_t to);
+
+/**
+ * @brief Allocate the rotating filter generations of an approximate table.
+ *
+ * @param config Capacity, false-positive target and generation count.
+ * @param expiry_seconds Minimum lifetime of an inserted MAC.
+ * @return The approximate state, or NULL on invalid config or allocation
+ * failure.
+ */
+mac_table_approx_t *mac_table_approx_create(
+    const mac_table_approx_config_t *config, size_t expiry_seconds);
+
+/**
+ * @brief Insert or refresh a MAC in an approximate table.
+ *
+ * @return `MAC_TABLE_INSERTED` if the MAC was not (apparently) present,
+ * `MAC_TABLE_UPDATED` otherwise.
+ */
+mac_entry_result_t mac_table_approx_insert(mac_table_t *table,
+                                           const uint8_t *mac);
+
+/**
+ * @brief Membership test against every live generation.
+ *
+ * @return `MAC_TABLE_OK` if the MAC was (probably) inserted within the expiry
+ * window, `MAC_TABLE_NOT_FOUND` otherwise.
+ */
+mac_entry_result_t mac_table_approx_exists(const mac_table_t *table,
+                                           const uint8_t *mac);
+
+/**
+ * @brief Forget every MAC of an approximate table.
+ *
+ * @return Estimated number of MACs that were present.
+ */
+size_t mac_table_approx_clear(mac_table_t *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MAC_TABLE_INTERNAL_H
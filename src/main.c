@@ -1,18 +1,27 @@
+#include <string.h>
 #include "mac_table.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 #define MAC_TABLE_SIZE 5
-#define MAC_ADDR_LEN 6
 
 static const char *TAG = "MAC_TABLE_TEST";
 
 mac_table_t mac_table;
 
+// Example key 00:1A:2B:3C:4D:<last>, cut or zero-padded to MAC_ADDR_LEN; the last byte keeps keys distinct
+static void make_test_mac(uint8_t last, uint8_t *mac) {
+    static const uint8_t prefix[] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D};
+    size_t prefix_len = MAC_ADDR_LEN - 1 < sizeof(prefix) ? MAC_ADDR_LEN - 1 : sizeof(prefix);
+    memset(mac, 0, MAC_ADDR_LEN);
+    memcpy(mac, prefix, prefix_len);
+    mac[MAC_ADDR_LEN - 1] = last;
+}
+
 // Dummy callback function to log events
 void mac_table_event_callback(int slot_index, const uint8_t *mac, mac_entry_result_t status) {
-    char mac_str[18];
+    char mac_str[MAC_ADDR_STR_LEN];
     mac_to_str(mac, mac_str);
 
     switch (status) {
@@ -50,12 +59,14 @@ void app_main(void) {
     mac_table_init(&mac_table, mac_table_entries, MAC_TABLE_SIZE, 30, mac_table_event_callback);
 
     // Test data
-    uint8_t test_mac_1[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E};
-    uint8_t test_mac_2[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5F};
-    uint8_t test_mac_3[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x60};
-    uint8_t test_mac_4[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x61};
-    uint8_t test_mac_5[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x62};
-    uint8_t test_mac_6[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x63}; // Will trigger table full
+    uint8_t test_mac_1[MAC_ADDR_LEN], test_mac_2[MAC_ADDR_LEN], test_mac_3[MAC_ADDR_LEN];
+    uint8_t test_mac_4[MAC_ADDR_LEN], test_mac_5[MAC_ADDR_LEN], test_mac_6[MAC_ADDR_LEN];
+    make_test_mac(0x5E, test_mac_1);
+    make_test_mac(0x5F, test_mac_2);
+    make_test_mac(0x60, test_mac_3);
+    make_test_mac(0x61, test_mac_4);
+    make_test_mac(0x62, test_mac_5);
+    make_test_mac(0x63, test_mac_6); // Will trigger table full
 
     // 1. Insert MAC addresses
     ESP_LOGI(TAG, "Inserting test MAC addresses...");
@@ -89,15 +100,18 @@ void app_main(void) {
     ESP_LOGI(TAG, "Retrieving MAC addresses...");
     mac_entry_t retrieved_entry;
     if (mac_table_get_by_index(&mac_table, 0, &retrieved_entry) == MAC_TABLE_OK) {
-        char mac_str[18];
-        mac_to_str(retrieved_entry.mac, mac_str);
+        char mac_str[MAC_ADDR_STR_LEN];
+        uint8_t retrieved_mac[MAC_ADDR_LEN];
+        mac_table_entry_mac(&mac_table, &retrieved_entry, retrieved_mac);
+        mac_to_str(retrieved_mac, mac_str);
         ESP_LOGI(TAG, "Entry at index 0: %s", mac_str);
     }
     vTaskDelay(pdMS_TO_TICKS(1000)); // Delay for 1 second
 
     // 4. Update a MAC address
     ESP_LOGI(TAG, "Updating MAC address...");
-    uint8_t updated_mac[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5E};  // Re-insert same MAC
+    uint8_t updated_mac[MAC_ADDR_LEN];
+    make_test_mac(0x5E, updated_mac);  // Re-insert same MAC
     mac_table_insert(&mac_table, updated_mac);  // Should trigger an update event
     vTaskDelay(pdMS_TO_TICKS(1000)); // Delay for 1 second
 
@@ -119,7 +133,9 @@ void app_main(void) {
     // 7. Expiry Handling - Simulate expiry by manually invoking callback
     ESP_LOGI(TAG, "Simulating expiry...");
     mac_entry_t *expired_entry = &mac_table.entries[0];  // Use first entry for simulation
-    mac_table_event_callback(0, expired_entry->mac, MAC_TABLE_TIMEOUT);
+    uint8_t expired_mac[MAC_ADDR_LEN];
+    mac_table_entry_mac(&mac_table, expired_entry, expired_mac);
+    mac_table_event_callback(0, expired_mac, MAC_TABLE_TIMEOUT);
     vTaskDelay(pdMS_TO_TICKS(1000)); // Delay for 1 second
 
     // 8. Re-insert to ensure full cycle works
@@ -129,7 +145,8 @@ void app_main(void) {
 
     while(1) {
         if (mac_table.stats->active_entries == 0) {
-        uint8_t test_mac_2[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x3C, 0x4D, 0x5F};
+        uint8_t test_mac_2[MAC_ADDR_LEN];
+        make_test_mac(0x5F, test_mac_2);
 
         // Custom options
         mac_insert_options_t opts;
@@ -0,0 +1,40 @@
+/* Minimal FreeRTOS stand-in so the library compiles on a development host for
+ * tests. Only what mac_table uses is declared; see host.h for the runtime. */
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "host.h"
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#define pvPortMalloc malloc
+#define vPortFree free
+
+// Library code reads the wall clock through time(); route it to the host clock
+static inline time_t host_time(time_t *out)
+{
+    if (out) {
+        *out = host_now;
+    }
+    return host_now;
+}
+#define time(out) host_time(out)
+
+// Report a wait that could only end if another task ran, then abort
+void host_block_forever(const char *what);
+
+#endif // HOST_FREERTOS_H
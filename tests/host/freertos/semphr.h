@@ -0,0 +1,45 @@
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include <stdio.h>
+#include "FreeRTOS.h"
+
+// Recursive mutex; the host runs one task at a time, so a take that would
+// have to wait for the other task can never succeed
+struct host_mutex {
+    int owner;
+    int depth;
+};
+typedef struct host_mutex *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return (SemaphoreHandle_t)calloc(1, sizeof(struct host_mutex));
+}
+
+static inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t s, TickType_t wait)
+{
+    if (s->depth > 0 && s->owner != host_task) {
+        if (wait != 0) {
+            host_block_forever("xSemaphoreTakeRecursive");
+        }
+        return pdFAIL;
+    }
+    s->owner = host_task;
+    s->depth++;
+    return pdPASS;
+}
+
+static inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t s)
+{
+    if (s->depth == 0 || s->owner != host_task) {
+        fprintf(stderr, "xSemaphoreGiveRecursive: mutex not held by this task\n");
+        abort();
+    }
+    s->depth--;
+    return pdPASS;
+}
+
+static inline void vSemaphoreDelete(SemaphoreHandle_t s) { free(s); }
+
+#endif // HOST_FREERTOS_SEMPHR_H
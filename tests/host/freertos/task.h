@@ -0,0 +1,28 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void *);
+typedef void *TaskHandle_t;
+
+// No scheduler on the host: task creation fails, so expiry stays in timer mode
+static inline BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                     UBaseType_t priority, TaskHandle_t *task)
+{
+    (void)fn, (void)name, (void)stack, (void)arg, (void)priority, (void)task;
+    return pdFAIL;
+}
+
+static inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                                 UBaseType_t priority, TaskHandle_t *task, BaseType_t core)
+{
+    (void)core;
+    return xTaskCreate(fn, name, stack, arg, priority, task);
+}
+
+static inline BaseType_t xTaskNotifyGive(TaskHandle_t task) { (void)task; return pdPASS; }
+static inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) { (void)clear, (void)wait; return 0; }
+static inline void vTaskDelete(TaskHandle_t task) { (void)task; }
+
+#endif // HOST_FREERTOS_TASK_H
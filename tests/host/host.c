@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#include "host.h"
+
+#define HOST_MAX_TIMERS 64
+#define HOST_EPOCH 1000000
+
+time_t host_now = HOST_EPOCH;
+int host_task = HOST_TASK_APP;
+size_t host_timer_runs;
+
+static TimerHandle_t timers[HOST_MAX_TIMERS];
+
+static TickType_t host_ticks(void)
+{
+    return (TickType_t)((host_now - HOST_EPOCH) * 1000); // Ticks are milliseconds
+}
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t reload, void *id,
+                           TimerCallbackFunction_t callback)
+{
+    (void)name, (void)reload;
+    for (size_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (!timers[i]) {
+            timers[i] = (TimerHandle_t)calloc(1, sizeof(struct host_timer));
+            if (timers[i]) {
+                timers[i]->id = id;
+                timers[i]->period = period;
+                timers[i]->callback = callback;
+            }
+            return timers[i];
+        }
+    }
+    return NULL;
+}
+
+BaseType_t xTimerChangePeriod(TimerHandle_t timer, TickType_t period, TickType_t wait)
+{
+    (void)wait;
+    timer->period = period;
+    return xTimerStart(timer, 0);
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait)
+{
+    (void)wait;
+    timer->expires = host_ticks() + timer->period;
+    timer->active = pdTRUE;
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t wait)
+{
+    (void)wait;
+    timer->active = pdFALSE;
+    return pdPASS;
+}
+
+BaseType_t xTimerDelete(TimerHandle_t timer, TickType_t wait)
+{
+    (void)wait;
+    for (size_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (timers[i] == timer) {
+            timers[i] = NULL;
+        }
+    }
+    free(timer);
+    return pdPASS;
+}
+
+BaseType_t xTimerIsTimerActive(TimerHandle_t timer)
+{
+    return timer->active;
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer)
+{
+    return timer->id;
+}
+
+// Earliest one-shot timer that is due, or NULL
+static TimerHandle_t host_due_timer(void)
+{
+    TimerHandle_t due = NULL;
+    for (size_t i = 0; i < HOST_MAX_TIMERS; i++) {
+        TimerHandle_t timer = timers[i];
+        if (timer && timer->active && timer->expires <= host_ticks() && (!due || timer->expires < due->expires)) {
+            due = timer;
+        }
+    }
+    return due;
+}
+
+void host_advance(time_t seconds)
+{
+    for (time_t s = 0; s < seconds; s++) {
+        host_now++;
+        TimerHandle_t timer;
+        while ((timer = host_due_timer()) != NULL) {
+            timer->active = pdFALSE;
+            host_task = HOST_TASK_TIMER;
+            timer->callback(timer);
+            host_task = HOST_TASK_APP;
+            host_timer_runs++;
+        }
+    }
+}
+
+void host_block_forever(const char *what)
+{
+    fprintf(stderr, "%s would block the %s task forever\n", what,
+            host_task == HOST_TASK_TIMER ? "timer service" : "application");
+    abort();
+}
@@ -0,0 +1,20 @@
+/* Host runtime for the tests: a clock the tests step, software timers that
+ * fire as it passes them, and the identity of the running task so the mutex
+ * stand-in can tell the timer service task from application code. */
+#ifndef HOST_H
+#define HOST_H
+
+#include <stddef.h>
+#include <time.h>
+
+#define HOST_TASK_APP 0
+#define HOST_TASK_TIMER 1
+
+extern time_t host_now;     // Seconds returned by time() in library code
+extern int host_task;       // Task the code is running as
+extern size_t host_timer_runs; // Timer callbacks run so far
+
+// Step the clock one second at a time, running every timer that comes due
+void host_advance(time_t seconds);
+
+#endif // HOST_H
@@ -0,0 +1,96 @@
+/* Host tests for pressure-adaptive aging: crossing an occupancy level
+ * shortens new TTLs and what is left of existing ones, and dropping back
+ * restores full TTLs for later inserts. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+static mac_entry_t entries[10];
+static mac_table_t table;
+static time_t start;
+
+static void make_mac(uint8_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[1] = 0x81;
+    mac[2] = id;
+}
+
+static void insert(uint8_t id)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    make_mac(id, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+}
+
+// Deadline of a MAC relative to the start of the test, or -1 if absent
+static time_t deadline(uint8_t id)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    make_mac(id, mac);
+    for (size_t i = 0; i < table.size; i++) {
+        uint8_t stored[MAC_ADDR_LEN];
+        if (table.entries[i].state == SLOT_OCCUPIED) {
+            mac_table_entry_mac(&table, &table.entries[i], stored);
+            if (memcmp(stored, mac, MAC_ADDR_LEN) == 0) {
+                return table.entries[i].timeout_duration - start;
+            }
+        }
+    }
+    return -1;
+}
+
+int main(void)
+{
+    const mac_table_aging_level_t levels[] = {{50, 50}, {80, 20}};
+    const mac_table_aging_level_t unordered[] = {{80, 20}, {50, 50}};
+    const mac_table_aging_level_t zero[] = {{50, 0}};
+    CHECK(mac_table_init(&table, entries, 10, 100, NULL));
+    CHECK(!mac_table_set_adaptive_aging(&table, unordered, 2));
+    CHECK(!mac_table_set_adaptive_aging(&table, zero, 1));
+    CHECK(mac_table_set_adaptive_aging(&table, levels, 2));
+    start = host_now;
+
+    for (uint8_t id = 1; id <= 4; id++) {
+        insert(id); // 40%: full TTL
+    }
+    CHECK(deadline(1) == 100);
+
+    // 50%: the new entry gets half the TTL, existing entries half of what is left
+    host_advance(10);
+    insert(5);
+    CHECK(deadline(5) == 10 + 50);
+    CHECK(deadline(1) == 10 + 45);
+
+    // 80%: scaled again, from 50% to 20%
+    host_advance(10);
+    insert(6);
+    insert(7);
+    CHECK(deadline(6) == 20 + 50);
+    insert(8);
+    CHECK(deadline(1) == 20 + 35 * 20 / 50);
+    CHECK(deadline(5) == 20 + 40 * 20 / 50);
+    CHECK(deadline(8) == 20 + 50 * 20 / 50);
+    insert(9);
+    CHECK(deadline(9) == 20 + 20);
+
+    // The shortened deadlines are the ones the expiry timer honours
+    host_advance(13);
+    CHECK(table.stats->active_entries == 9);
+    host_advance(1);
+    CHECK(deadline(1) == -1 && deadline(4) == -1 && deadline(5) == 36);
+    CHECK(table.stats->active_entries == 5);
+
+    // Dropping back to 50% relaxes the step for later inserts only
+    insert(10);
+    CHECK(deadline(10) == 34 + 50);
+    CHECK(deadline(6) == 40);
+
+    // Back under the first level: full TTLs again
+    host_advance(6);
+    CHECK(table.stats->active_entries == 1);
+    insert(11);
+    CHECK(deadline(11) == 40 + 100);
+
+    return test_report("test_adaptive_aging");
+}
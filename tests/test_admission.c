@@ -0,0 +1,121 @@
+/* Host tests for admission control: the token bucket on new entries, and the
+ * per-MAC limit that drops refreshes which would barely move the deadline. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_entry_t entries[8];
+static mac_table_t table;
+
+static void make_mac(uint8_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[1] = 0x88;
+    mac[2] = id;
+}
+
+static mac_entry_result_t insert_id(uint8_t id)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    make_mac(id, mac);
+    return mac_table_insert(&table, mac);
+}
+
+static mac_entry_result_t delete_id(uint8_t id)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    make_mac(id, mac);
+    return mac_table_delete(&table, mac);
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 8, 100, test_record_event));
+
+    mac_table_admission_config_t config = {.inserts_per_second = 2, .insert_burst = 0};
+    CHECK(!mac_table_set_admission_control(&table, &config));
+    config.insert_burst = 4;
+    CHECK(mac_table_set_admission_control(&table, &config));
+
+    // A burst drains the bucket; rejections are counted but not reported
+    for (uint8_t id = 1; id <= 4; id++) {
+        CHECK(insert_id(id) == MAC_TABLE_INSERTED);
+    }
+    size_t events = test_event_count;
+    CHECK(insert_id(5) == MAC_TABLE_RATE_LIMITED);
+    CHECK(table.stats->total_rate_limited == 1);
+    CHECK(test_event_count == events);
+    CHECK(table.stats->active_entries == 4);
+
+    // Refill at the sustained rate
+    host_advance(1);
+    CHECK(insert_id(5) == MAC_TABLE_INSERTED);
+    CHECK(insert_id(6) == MAC_TABLE_INSERTED);
+    CHECK(insert_id(7) == MAC_TABLE_RATE_LIMITED);
+    CHECK(table.stats->total_rate_limited == 2);
+
+    // Refreshes of known MACs never spend tokens
+    CHECK(insert_id(1) == MAC_TABLE_UPDATED);
+
+    // Inserts into a full table fail without spending the budget
+    host_advance(1);
+    CHECK(insert_id(7) == MAC_TABLE_INSERTED);
+    CHECK(insert_id(8) == MAC_TABLE_INSERTED);
+    host_advance(2);
+    for (uint8_t id = 9; id <= 20; id++) {
+        CHECK(insert_id(id) == MAC_TABLE_FULL);
+    }
+    for (uint8_t id = 1; id <= 4; id++) {
+        CHECK(delete_id(id) == MAC_TABLE_DELETED);
+    }
+    for (uint8_t id = 9; id <= 12; id++) {
+        CHECK(insert_id(id) == MAC_TABLE_INSERTED);
+    }
+    CHECK(delete_id(9) == MAC_TABLE_DELETED);
+    CHECK(insert_id(13) == MAC_TABLE_RATE_LIMITED);
+
+    // Per-MAC limit: a refresh must gain at least min_refresh_seconds
+    CHECK(mac_table_set_admission_control(&table, NULL));
+    CHECK(mac_table_reset_stats(&table));
+    config = (mac_table_admission_config_t){.min_refresh_seconds = 10};
+    CHECK(mac_table_set_admission_control(&table, &config));
+
+    make_mac(12, mac);
+    events = test_event_count;
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_RATE_LIMITED);
+    host_advance(9);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_RATE_LIMITED);
+    CHECK(table.stats->total_rate_limited == 2);
+    CHECK(test_event_count == events);
+    host_advance(1);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_UPDATED);
+
+    // Lookups do not count as refreshes
+    host_advance(10);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_UPDATED);
+
+    // Changing the role or the lifetime is never limited
+    mac_insert_options_t opts = {.has_role = true, .role = 3};
+    CHECK(mac_table_insert_ex(&table, mac, &opts) == MAC_TABLE_UPDATED);
+    CHECK(mac_table_insert_ex(&table, mac, &opts) == MAC_TABLE_RATE_LIMITED);
+    opts = (mac_insert_options_t){.has_custom_duration = true, .custom_duration = 5};
+    CHECK(mac_table_insert_ex(&table, mac, &opts) == MAC_TABLE_UPDATED);
+
+    // After a short custom lifetime a plain refresh gains plenty and is applied
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_UPDATED);
+
+    // A stale entry is always revived, however soon
+    CHECK(mac_table_set_stale_timeout(&table, 500));
+    host_advance(100);
+    make_mac(11, mac);
+    CHECK(table.stats->stale_entries > 0);
+    config.min_refresh_seconds = 1000;
+    CHECK(mac_table_set_admission_control(&table, &config));
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_UPDATED);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_RATE_LIMITED);
+
+    return test_report("test_admission");
+}
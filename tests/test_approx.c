@@ -0,0 +1,97 @@
+/* Host tests for approximate tables: no false negatives inside the expiry
+ * window, a bounded false-positive rate, and ageing out by generation. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+#define PRESENT 500
+#define ABSENT 10000
+
+static mac_table_t table;
+
+static void make_mac(uint32_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[0] = 0x91;
+    mac[1] = (uint8_t)(id >> 16);
+    mac[2] = (uint8_t)(id >> 8);
+    mac[3] = (uint8_t)id;
+}
+
+static size_t count_present(uint32_t first, uint32_t count)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    size_t found = 0;
+    for (uint32_t id = first; id < first + count; id++) {
+        make_mac(id, mac);
+        found += mac_table_exists(&table, mac) == MAC_TABLE_OK;
+    }
+    return found;
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    mac_table_approx_config_t config = {.capacity = PRESENT, .false_positive_rate = 0.01f, .generations = 1};
+    CHECK(!mac_table_init_approx(&table, &config, 60, test_record_event));
+    config.generations = 4; // A generation retires every 20 s
+    CHECK(mac_table_init_approx(&table, &config, 60, test_record_event));
+
+    // Per-entry policies do not apply
+    mac_hot_cache_line_t lines[4];
+    mac_table_admission_config_t admission = {.min_refresh_seconds = 1};
+    CHECK(!mac_table_set_la_partition(&table, 1, 10));
+    CHECK(!mac_table_set_admission_control(&table, &admission));
+    CHECK(!mac_table_enable_hot_cache(&table, lines, 4));
+    CHECK(!mac_table_set_stale_timeout(&table, 10));
+
+    size_t inserted = 0;
+    for (uint32_t id = 0; id < PRESENT; id++) {
+        make_mac(id, mac);
+        inserted += mac_table_insert(&table, mac) == MAC_TABLE_INSERTED;
+    }
+    CHECK(inserted >= PRESENT - 10);
+    CHECK(test_event_count == PRESENT && test_events[0].slot == -1);
+    CHECK(table.stats->active_entries == inserted);
+    make_mac(0, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_UPDATED);
+    CHECK(mac_table_delete(&table, mac) == MAC_TABLE_NOT_FOUND);
+
+    // Every inserted MAC is found; few absent ones are
+    CHECK(count_present(0, PRESENT) == PRESENT);
+    CHECK(count_present(PRESENT, ABSENT) < ABSENT * 2 / 100);
+
+    // Present for at least the expiry time, gone once every generation holding
+    // it has retired
+    host_advance(79);
+    CHECK(count_present(0, PRESENT) == PRESENT);
+    host_advance(1);
+    CHECK(count_present(0, PRESENT) == 0);
+    CHECK(table.stats->active_entries == 0);
+    CHECK(table.stats->total_expired == inserted);
+
+    // A refresh moves the MAC to the newest generation
+    make_mac(1, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    host_advance(50);
+    CHECK(mac_table_touch(&table, mac) == MAC_TABLE_UPDATED);
+    host_advance(69);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+    host_advance(1);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    CHECK(mac_table_touch(&table, mac) == MAC_TABLE_NOT_FOUND);
+
+    // Clearing forgets everything and reports the estimate
+    for (uint32_t id = 0; id < 100; id++) {
+        make_mac(id, mac);
+        mac_table_insert(&table, mac);
+    }
+    size_t estimate = table.stats->active_entries;
+    CHECK(estimate >= 95 && estimate <= 100);
+    CHECK(mac_table_clear(&table) == (int)estimate);
+    CHECK(count_present(0, 100) == 0);
+    CHECK(table.stats->active_entries == 0);
+
+    return test_report("test_approx");
+}
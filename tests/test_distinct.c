@@ -0,0 +1,77 @@
+/* Host tests for the distinct-MAC estimator: accuracy within the sketch's
+ * error, rejected inserts counted as demand, and the sliding window. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+static mac_entry_t entries[64];
+static mac_table_t table;
+static uint8_t registers[256 * 4];
+
+// Offer `count` random MACs; the stream restarts from `seed`
+static void offer(uint32_t seed, size_t count)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    test_rand_state = seed;
+    for (size_t i = 0; i < count; i++) {
+        test_random_key(mac, MAC_ADDR_LEN);
+        mac_table_insert(&table, mac);
+    }
+}
+
+static bool near(size_t estimate, size_t expected, size_t percent)
+{
+    size_t margin = expected * percent / 100;
+    return estimate + margin >= expected && estimate <= expected + margin;
+}
+
+int main(void)
+{
+    CHECK(mac_table_init(&table, entries, 64, 1000, NULL));
+    CHECK(mac_table_estimate_distinct(&table) == 0);
+    CHECK(!mac_table_enable_distinct_estimator(&table, registers, 200, 1, 0));
+    CHECK(!mac_table_enable_distinct_estimator(&table, registers, 8, 1, 0));
+    CHECK(!mac_table_enable_distinct_estimator(&table, registers, 256, 0, 0));
+    CHECK(!mac_table_enable_distinct_estimator(&table, registers, 256, 4, 0));
+    CHECK(mac_table_enable_distinct_estimator(&table, registers, 256, 1, 0));
+
+    // Small counts are near exact; a full table still counts what it rejects
+    offer(1, 40);
+    CHECK(near(mac_table_estimate_distinct(&table), 40, 10));
+    offer(2, 5000);
+    CHECK(table.stats->active_entries == 64);
+    CHECK(near(mac_table_estimate_distinct(&table), 5040, 20));
+
+    // Repeats add nothing
+    size_t estimate = mac_table_estimate_distinct(&table);
+    offer(2, 5000);
+    CHECK(mac_table_estimate_distinct(&table) == estimate);
+
+    // Rate-limited inserts are counted as well
+    CHECK(mac_table_clear(&table) == 64);
+    mac_table_admission_config_t admission = {.inserts_per_second = 1, .insert_burst = 1};
+    CHECK(mac_table_set_admission_control(&table, &admission));
+    CHECK(mac_table_enable_distinct_estimator(&table, registers, 256, 1, 0));
+    offer(3, 2000);
+    CHECK(table.stats->active_entries == 1);
+    CHECK(near(mac_table_estimate_distinct(&table), 2000, 20));
+    CHECK(mac_table_set_admission_control(&table, NULL));
+
+    // A window of 60 s over 4 generations forgets MACs after 60 to 80 s
+    CHECK(mac_table_enable_distinct_estimator(&table, registers, 256, 4, 60));
+    offer(4, 1000);
+    CHECK(near(mac_table_estimate_distinct(&table), 1000, 20));
+    host_advance(40);
+    offer(5, 300);
+    CHECK(near(mac_table_estimate_distinct(&table), 1300, 20));
+    host_advance(40);
+    CHECK(near(mac_table_estimate_distinct(&table), 300, 20));
+    host_advance(80);
+    CHECK(mac_table_estimate_distinct(&table) == 0);
+
+    // Disabling
+    CHECK(mac_table_enable_distinct_estimator(&table, NULL, 0, 0, 0));
+    CHECK(mac_table_estimate_distinct(&table) == 0);
+
+    return test_report("test_distinct");
+}
@@ -0,0 +1,57 @@
+/* Event recorder for tests that pass it as a table's `on_event` callback. */
+#ifndef TEST_EVENTS_H
+#define TEST_EVENTS_H
+
+#include <string.h>
+#include "mac_table.h"
+
+#define TEST_MAX_EVENTS 4096
+
+typedef struct {
+    int slot;
+    uint8_t mac[MAC_ADDR_LEN];
+    mac_entry_result_t status;
+} test_event_t;
+
+static test_event_t test_events[TEST_MAX_EVENTS];
+static size_t test_event_count;
+
+static inline void test_record_event(int slot, const uint8_t *mac, mac_entry_result_t status)
+{
+    if (test_event_count < TEST_MAX_EVENTS) {
+        test_event_t *event = &test_events[test_event_count++];
+        event->slot = slot;
+        event->status = status;
+        if (mac) {
+            memcpy(event->mac, mac, MAC_ADDR_LEN);
+        } else {
+            memset(event->mac, 0, MAC_ADDR_LEN);
+        }
+    }
+}
+
+static inline void test_clear_events(void)
+{
+    test_event_count = 0;
+}
+
+static inline size_t test_count_events(mac_entry_result_t status)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < test_event_count; i++) {
+        count += test_events[i].status == status;
+    }
+    return count;
+}
+
+// Events of one kind for one MAC
+static inline size_t test_count_mac_events(const uint8_t *mac, mac_entry_result_t status)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < test_event_count; i++) {
+        count += test_events[i].status == status && memcmp(test_events[i].mac, mac, MAC_ADDR_LEN) == 0;
+    }
+    return count;
+}
+
+#endif // TEST_EVENTS_H
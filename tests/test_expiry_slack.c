@@ -0,0 +1,58 @@
+/* Host tests for the expiry slack window: deadlines inside one bucket share a
+ * wakeup, and no entry expires before its deadline or after its bucket. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+#define ENTRIES 20
+
+static time_t deadlines[ENTRIES];
+static size_t expired;
+
+static void on_event(int slot, const uint8_t *mac, mac_entry_result_t status)
+{
+    (void)slot;
+    if (status != MAC_TABLE_TIMEOUT) {
+        return;
+    }
+    expired++;
+    time_t deadline = deadlines[mac[0]];
+    CHECK(host_now >= deadline);
+    CHECK(host_now < deadline + 10);
+}
+
+// Timer wakeups needed to expire ENTRIES deadlines spread one second apart
+static size_t wakeups_with_slack(uint32_t slack_seconds)
+{
+    static mac_entry_t entries[ENTRIES];
+    mac_table_t table;
+    CHECK(mac_table_init(&table, entries, ENTRIES, 60, on_event));
+    CHECK(mac_table_set_expiry_slack(&table, slack_seconds));
+
+    host_advance(3); // Start off a bucket boundary
+    for (size_t i = 0; i < ENTRIES; i++) {
+        uint8_t mac[MAC_ADDR_LEN] = {(uint8_t)i, 0x42};
+        mac_insert_options_t opts = {0};
+        opts.has_custom_duration = true;
+        opts.custom_duration = (time_t)(i + 1);
+        deadlines[i] = host_now + opts.custom_duration;
+        CHECK(mac_table_insert_ex(&table, mac, &opts) == MAC_TABLE_INSERTED);
+    }
+
+    expired = 0;
+    size_t runs = host_timer_runs;
+    host_advance(ENTRIES + 10);
+    CHECK(expired == ENTRIES);
+    CHECK(table.stats->active_entries == 0);
+    expiry_manager_free(table.expiry_manager);
+    return host_timer_runs - runs;
+}
+
+int main(void)
+{
+    CHECK(wakeups_with_slack(0) == ENTRIES);
+    CHECK(wakeups_with_slack(1) == ENTRIES);
+    CHECK(wakeups_with_slack(10) <= ENTRIES / 10 + 1);
+    CHECK(!mac_table_set_expiry_slack(NULL, 10));
+    return test_report("test_expiry_slack");
+}
@@ -0,0 +1,91 @@
+/* Host tests for pre-expiry warnings: MAC_TABLE_EXPIRING arrives the grace
+ * period ahead of the timeout, and a refresh in between keeps the entry. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_entry_t entries[8];
+static mac_table_t table;
+static uint8_t keepalive_mac[MAC_ADDR_LEN];
+static int keepalives_left;
+
+// Answers the first warnings for one MAC by refreshing it, as a prober would
+static void on_event(int slot, const uint8_t *mac, mac_entry_result_t status)
+{
+    test_record_event(slot, mac, status);
+    if (status == MAC_TABLE_EXPIRING && keepalives_left > 0 && memcmp(mac, keepalive_mac, MAC_ADDR_LEN) == 0) {
+        keepalives_left--;
+        CHECK(mac_table_touch(&table, mac) == MAC_TABLE_UPDATED);
+    }
+}
+
+static void make_mac(uint8_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[1] = 0x84;
+    mac[2] = id;
+}
+
+int main(void)
+{
+    uint8_t a[MAC_ADDR_LEN], b[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 8, 100, on_event));
+    CHECK(mac_table_set_expiry_warning(&table, 10));
+
+    // Warning at the grace point, timeout at the deadline
+    make_mac(1, a);
+    CHECK(mac_table_insert(&table, a) == MAC_TABLE_INSERTED);
+    host_advance(89);
+    CHECK(test_count_mac_events(a, MAC_TABLE_EXPIRING) == 0);
+    host_advance(1);
+    CHECK(test_count_mac_events(a, MAC_TABLE_EXPIRING) == 1);
+    CHECK(test_count_mac_events(a, MAC_TABLE_TIMEOUT) == 0);
+    CHECK(mac_table_exists(&table, a) == MAC_TABLE_OK);
+    host_advance(9);
+    CHECK(test_count_mac_events(a, MAC_TABLE_TIMEOUT) == 0);
+    host_advance(1);
+    CHECK(test_count_mac_events(a, MAC_TABLE_TIMEOUT) == 1);
+
+    // A refresh after the warning cancels the pending timeout
+    CHECK(mac_table_insert(&table, a) == MAC_TABLE_INSERTED);
+    host_advance(95);
+    CHECK(test_count_mac_events(a, MAC_TABLE_EXPIRING) == 2);
+    CHECK(mac_table_insert(&table, a) == MAC_TABLE_UPDATED);
+    host_advance(10);
+    CHECK(test_count_mac_events(a, MAC_TABLE_TIMEOUT) == 1);
+    host_advance(80);
+    CHECK(test_count_mac_events(a, MAC_TABLE_EXPIRING) == 3);
+    CHECK(mac_table_delete(&table, a) == MAC_TABLE_DELETED);
+
+    // Refreshing from the callback keeps the entry for another lifetime
+    make_mac(2, b);
+    memcpy(keepalive_mac, b, MAC_ADDR_LEN);
+    keepalives_left = 1;
+    CHECK(mac_table_insert(&table, b) == MAC_TABLE_INSERTED);
+    host_advance(100);
+    CHECK(test_count_mac_events(b, MAC_TABLE_EXPIRING) == 1);
+    CHECK(test_count_mac_events(b, MAC_TABLE_TIMEOUT) == 0);
+    host_advance(79);
+    CHECK(test_count_mac_events(b, MAC_TABLE_EXPIRING) == 1);
+    host_advance(1);
+    CHECK(test_count_mac_events(b, MAC_TABLE_EXPIRING) == 2);
+    host_advance(10);
+    CHECK(test_count_mac_events(b, MAC_TABLE_TIMEOUT) == 1);
+
+    // A lifetime shorter than the grace period expires without a warning
+    mac_insert_options_t opts = {.has_custom_duration = true, .custom_duration = 5};
+    CHECK(mac_table_insert_ex(&table, a, &opts) == MAC_TABLE_INSERTED);
+    host_advance(5);
+    CHECK(test_count_mac_events(a, MAC_TABLE_EXPIRING) == 3);
+    CHECK(test_count_mac_events(a, MAC_TABLE_TIMEOUT) == 2);
+
+    // Disabling warnings applies from the next schedule
+    CHECK(mac_table_set_expiry_warning(&table, 0));
+    CHECK(mac_table_insert(&table, a) == MAC_TABLE_INSERTED);
+    host_advance(100);
+    CHECK(test_count_mac_events(a, MAC_TABLE_EXPIRING) == 3);
+    CHECK(test_count_mac_events(a, MAC_TABLE_TIMEOUT) == 3);
+
+    return test_report("test_expiry_warning");
+}
@@ -0,0 +1,67 @@
+/* Host tests for running expiry outside the caller's task: the timer callback
+ * must not block on a lock held by the application, and expiry stays on the
+ * timer when no worker task can be created. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_table_t table;
+
+// Lookups from inside an expiry event take the lock again on the timer task
+static void reentrant_event(int slot, const uint8_t *mac, mac_entry_result_t status)
+{
+    test_record_event(slot, mac, status);
+    if (status == MAC_TABLE_TIMEOUT) {
+        CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    }
+}
+
+static void test_lock_defers_expiry(void)
+{
+    static mac_entry_t entries[8];
+    uint8_t mac[MAC_ADDR_LEN] = {0x00, 0x11, 0x22};
+    test_clear_events();
+    CHECK(mac_table_init(&table, entries, 8, 5, reentrant_event));
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+
+    // Held across the deadline: the timer retries instead of blocking its task
+    mac_table_lock(&table);
+    host_advance(10);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+    CHECK(test_count_events(MAC_TABLE_TIMEOUT) == 0);
+    mac_table_unlock(&table);
+
+    host_advance(1);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    CHECK(test_count_events(MAC_TABLE_TIMEOUT) == 1);
+    expiry_manager_free(table.expiry_manager);
+}
+
+static void test_worker_unavailable(void)
+{
+    static mac_entry_t entries[8];
+    uint8_t mac[MAC_ADDR_LEN] = {0x00, 0x11, 0x33};
+    mac_table_expiry_worker_config_t config = {.priority = 5, .core_id = MAC_TABLE_NO_AFFINITY};
+    test_clear_events();
+    CHECK(mac_table_init(&table, entries, 8, 5, reentrant_event));
+
+    CHECK(!mac_table_start_expiry_worker(&table, NULL));
+    CHECK(!mac_table_start_expiry_worker(&table, &config)); // The host cannot create tasks
+
+    // The timer still owns the deadlines
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    host_advance(4);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+    host_advance(1);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    CHECK(test_count_mac_events(mac, MAC_TABLE_TIMEOUT) == 1);
+    expiry_manager_free(table.expiry_manager);
+}
+
+int main(void)
+{
+    test_lock_defers_expiry();
+    test_worker_unavailable();
+    return test_report("test_expiry_worker");
+}
@@ -0,0 +1,94 @@
+/* Host tests for the counting Bloom filter in front of lookups: no false
+ * negatives, and removed MACs stop passing the filter. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+#define KEYS 64
+
+static mac_entry_t entries[128];
+static mac_table_t table;
+static uint8_t counters[1024];
+
+static void make_mac(uint16_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[0] = 0x90;
+    mac[1] = (uint8_t)(id >> 8);
+    mac[2] = (uint8_t)id;
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 128, 100, NULL));
+
+    // Entries already in the table are added when the filter is enabled
+    for (uint16_t id = 0; id < 16; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    CHECK(!mac_table_enable_filter(&table, counters, 1000, 4));
+    CHECK(!mac_table_enable_filter(&table, counters, 1024, 0));
+    CHECK(mac_table_enable_filter(&table, counters, 1024, 4));
+    for (uint16_t id = 0; id < 16; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+    }
+    CHECK(table.stats->total_filter_rejects == 0);
+
+    // Random traffic: never a false negative
+    bool present[KEYS] = {false};
+    for (uint16_t id = 0; id < 16; id++) {
+        present[id] = true;
+    }
+    for (int op = 0; op < 20000; op++) {
+        uint16_t id = (uint16_t)(test_rand() % KEYS);
+        make_mac(id, mac);
+        switch (test_rand() % 3) {
+        case 0:
+            CHECK(mac_table_insert(&table, mac) == (present[id] ? MAC_TABLE_UPDATED : MAC_TABLE_INSERTED));
+            present[id] = true;
+            break;
+        case 1:
+            CHECK(mac_table_delete(&table, mac) == (present[id] ? MAC_TABLE_DELETED : MAC_TABLE_NOT_FOUND));
+            present[id] = false;
+            break;
+        default:
+            CHECK(mac_table_exists(&table, mac) == (present[id] ? MAC_TABLE_OK : MAC_TABLE_NOT_FOUND));
+            break;
+        }
+    }
+
+    // Deletes and expiries take MACs back out, so most misses are rejected
+    // by the filter without probing
+    host_advance(100);
+    CHECK(table.stats->active_entries == 0);
+    size_t rejects = table.stats->total_filter_rejects;
+    for (uint16_t id = 0; id < 1000; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    }
+    CHECK(table.stats->total_filter_rejects - rejects > 950);
+
+    // With 64 MACs in 1024 counters, few misses get through
+    for (uint16_t id = 0; id < KEYS; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    rejects = table.stats->total_filter_rejects;
+    for (uint16_t id = KEYS; id < KEYS + 1000; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    }
+    CHECK(table.stats->total_filter_rejects - rejects > 900);
+
+    // Disabling stops filtering
+    CHECK(mac_table_enable_filter(&table, NULL, 0, 0));
+    rejects = table.stats->total_filter_rejects;
+    make_mac(KEYS, mac);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    CHECK(table.stats->total_filter_rejects == rejects);
+
+    return test_report("test_filter");
+}
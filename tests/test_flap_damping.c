@@ -0,0 +1,89 @@
+/* Host tests for flap damping: MACs that keep expiring and returning are
+ * held longer, the penalty decays with time, and a clock stepped backwards
+ * does not decay it at all. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_entry_t entries[8];
+static mac_table_t table;
+static mac_flap_record_t records[16];
+
+static void make_mac(uint8_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[1] = 0x86;
+    mac[2] = id;
+}
+
+// Insert and let the entry time out; returns the seconds it lived
+static time_t insert_and_expire(const uint8_t *mac)
+{
+    size_t timeouts = test_count_mac_events(mac, MAC_TABLE_TIMEOUT);
+    time_t lived = 0;
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    while (test_count_mac_events(mac, MAC_TABLE_TIMEOUT) == timeouts && lived < 1000) {
+        host_advance(1);
+        lived++;
+    }
+    return lived;
+}
+
+int main(void)
+{
+    uint8_t a[MAC_ADDR_LEN], b[MAC_ADDR_LEN], c[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 8, 10, test_record_event));
+
+    mac_table_flap_config_t config = {
+        .flap_penalty = 1000,
+        .suppress_threshold = 2500,
+        .half_life_seconds = 0,
+        .ttl_multiplier = 4,
+    };
+    CHECK(!mac_table_enable_flap_damping(&table, records, 16, &config));
+    config.half_life_seconds = 60;
+    CHECK(!mac_table_enable_flap_damping(&table, records, 16, NULL));
+    CHECK(mac_table_enable_flap_damping(&table, records, 16, &config));
+
+    // The first expiry is free; each quick return adds a penalty until damped
+    make_mac(1, a);
+    CHECK(insert_and_expire(a) == 10);
+    CHECK(insert_and_expire(a) == 10); // 1000
+    CHECK(insert_and_expire(a) == 10); // 2000
+    CHECK(table.stats->total_flap_damped == 0);
+    CHECK(insert_and_expire(a) == 40); // 3000: damped, TTL x4
+    CHECK(table.stats->total_flap_damped == 1);
+
+    // Returning again right away is damped again, and the entry carries the flag
+    CHECK(mac_table_insert(&table, a) == MAC_TABLE_INSERTED);
+    mac_entry_t copy;
+    CHECK(mac_table_get_by_index(&table, (size_t)test_events[test_event_count - 1].slot, &copy) == MAC_TABLE_OK);
+    CHECK(copy.flags & MAC_ENTRY_FLAG_DAMPED);
+    CHECK(table.stats->total_flap_damped == 2);
+    CHECK(mac_table_delete(&table, a) == MAC_TABLE_DELETED);
+
+    // The penalty halves every half-life, so a slower flapper stays undamped
+    make_mac(2, b);
+    CHECK(insert_and_expire(b) == 10);
+    CHECK(insert_and_expire(b) == 10); // 1000
+    CHECK(insert_and_expire(b) == 10); // 2000
+    host_advance(60);
+    CHECK(insert_and_expire(b) == 10); // 1000 + 1000
+    CHECK(table.stats->total_flap_damped == 2);
+
+    // A clock stepped backwards keeps the penalty as it was
+    make_mac(3, c);
+    CHECK(insert_and_expire(c) == 10);
+    CHECK(insert_and_expire(c) == 10); // 1000
+    CHECK(insert_and_expire(c) == 10); // 2000
+    host_now -= 100;
+    CHECK(insert_and_expire(c) == 40); // 3000
+    CHECK(table.stats->total_flap_damped == 3);
+
+    // Disabling forgets the history
+    CHECK(mac_table_enable_flap_damping(&table, NULL, 0, NULL));
+    CHECK(insert_and_expire(a) == 10);
+
+    return test_report("test_flap_damping");
+}
@@ -0,0 +1,107 @@
+/* Host tests for frozen snapshots: the Eytzinger descent must find every key
+ * for every tree shape, and miss keys below, between and above the stored
+ * ones, including on an empty snapshot. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "mac_table.h"
+#include "test_util.h"
+
+#define MAX_KEYS 70
+
+#if MAC_ADDR_LEN <= 7
+static int compare_keys(const void *a, const void *b)
+{
+    return memcmp(a, b, MAC_ADDR_LEN);
+}
+
+static void fill_table(mac_table_t *table, uint8_t (*keys)[MAC_ADDR_LEN], size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        mac_insert_options_t opts = {0};
+        opts.has_role = true;
+        opts.role = (uint8_t)(i + 1);
+        CHECK(mac_table_insert_ex(table, keys[i], &opts) == MAC_TABLE_INSERTED);
+    }
+}
+
+static void check_shape(size_t count)
+{
+    static mac_entry_t entries[2 * MAX_KEYS];
+    uint8_t keys[MAX_KEYS][MAC_ADDR_LEN];
+    mac_table_t table;
+    CHECK(mac_table_init(&table, entries, 2 * MAX_KEYS, 3600, NULL));
+
+    // Distinct keys with even low bytes, so odd neighbours are known misses
+    for (size_t i = 0; i < count; i++) {
+        bool fresh;
+        do {
+            test_random_key(keys[i], MAC_ADDR_LEN);
+            keys[i][MAC_ADDR_LEN - 1] &= 0xFE;
+            keys[i][0] = (uint8_t)(keys[i][0] % 0xF0 + 1); // Room below and above
+            fresh = true;
+            for (size_t j = 0; j < i && fresh; j++) {
+                fresh = memcmp(keys[i], keys[j], MAC_ADDR_LEN) != 0;
+            }
+        } while (!fresh);
+    }
+    fill_table(&table, keys, count);
+
+    mac_table_frozen_t frozen;
+    CHECK(mac_table_freeze(&table, &frozen));
+    CHECK(frozen.count == count);
+
+    // A later change to the table does not reach the snapshot
+    if (count > 0) {
+        CHECK(mac_table_delete(&table, keys[0]) == MAC_TABLE_DELETED);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        uint8_t role = 0;
+        CHECK(mac_table_frozen_lookup(&frozen, keys[i], &role) == MAC_TABLE_OK);
+        CHECK(role == (uint8_t)(i + 1));
+
+        uint8_t neighbour[MAC_ADDR_LEN];
+        memcpy(neighbour, keys[i], MAC_ADDR_LEN);
+        neighbour[MAC_ADDR_LEN - 1] |= 0x01;
+        CHECK(mac_table_frozen_exists(&frozen, neighbour) == MAC_TABLE_NOT_FOUND);
+    }
+
+    // Below every key, and above every key (the descent runs off the right edge)
+    uint8_t lowest[MAC_ADDR_LEN] = {0};
+    uint8_t highest[MAC_ADDR_LEN];
+    memset(highest, 0xFF, sizeof(highest));
+    CHECK(mac_table_frozen_exists(&frozen, lowest) == MAC_TABLE_NOT_FOUND);
+    CHECK(mac_table_frozen_exists(&frozen, highest) == MAC_TABLE_NOT_FOUND);
+
+    // The largest stored key must still be found when nothing is greater
+    if (count > 0) {
+        qsort(keys, count, MAC_ADDR_LEN, compare_keys);
+        CHECK(mac_table_frozen_exists(&frozen, keys[count - 1]) == MAC_TABLE_OK);
+        CHECK(mac_table_frozen_exists(&frozen, keys[0]) == MAC_TABLE_OK);
+    }
+
+    mac_table_frozen_free(&frozen);
+    CHECK(frozen.records == NULL && frozen.count == 0);
+    CHECK(mac_table_frozen_exists(&frozen, highest) == MAC_TABLE_NOT_FOUND);
+    expiry_manager_free(table.expiry_manager);
+}
+#endif
+
+int main(void)
+{
+#if MAC_ADDR_LEN <= 7
+    for (size_t count = 0; count <= MAX_KEYS; count++) {
+        check_shape(count);
+    }
+#else
+    // Records hold the key and role in 64 bits, so wider keys are refused
+    static mac_entry_t entries[4];
+    mac_table_t table;
+    mac_table_frozen_t frozen;
+    CHECK(mac_table_init(&table, entries, 4, 3600, NULL));
+    CHECK(!mac_table_freeze(&table, &frozen));
+    expiry_manager_free(table.expiry_manager);
+#endif
+    return test_report("test_frozen");
+}
@@ -0,0 +1,88 @@
+/* Host tests for heavy-hitter tracking: a MAC flooding the table tops the
+ * list even when every one of its inserts is rejected. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+static mac_entry_t entries[8];
+static mac_table_t table;
+static mac_heavy_hitter_t counters[8];
+
+static void make_mac(uint16_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[0] = 0x93;
+    mac[1] = (uint8_t)(id >> 8);
+    mac[2] = (uint8_t)id;
+}
+
+// Background traffic: lookups of resident MACs and one-off inserts of others
+static void background(uint16_t first_stranger, int rounds)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    for (int i = 0; i < rounds; i++) {
+        make_mac((uint16_t)(test_rand() % 4), mac);
+        mac_table_exists(&table, mac);
+        make_mac((uint16_t)(first_stranger + i), mac);
+        mac_table_insert(&table, mac);
+    }
+}
+
+static void check_top(const uint8_t *mac, uint32_t at_least)
+{
+    mac_heavy_hitter_t top[8];
+    size_t n = mac_table_get_heavy_hitters(&table, top, 8);
+    CHECK(n > 0);
+    CHECK(memcmp(top[0].mac, mac, MAC_ADDR_LEN) == 0);
+    CHECK(top[0].count >= at_least && top[0].error < top[0].count);
+    for (size_t i = 1; i < n; i++) {
+        CHECK(top[i].count <= top[i - 1].count);
+    }
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN], flooder[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 8, 1000, NULL));
+    CHECK(mac_table_enable_heavy_hitters(&table, counters, 8));
+
+    // A full table rejects every insert of the flooder
+    for (uint16_t id = 0; id < 8; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    make_mac(1000, flooder);
+    for (int i = 0; i < 500; i++) {
+        CHECK(mac_table_insert(&table, flooder) == MAC_TABLE_FULL);
+        background((uint16_t)(2000 + i), 1);
+    }
+    background(3000, 200);
+    check_top(flooder, 500);
+
+    // Rate-limited inserts count the same way
+    CHECK(mac_table_clear(&table) == 8);
+    CHECK(mac_table_enable_heavy_hitters(&table, counters, 8));
+    mac_table_admission_config_t admission = {.inserts_per_second = 1, .insert_burst = 1};
+    CHECK(mac_table_set_admission_control(&table, &admission));
+    make_mac(0, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    make_mac(1001, flooder);
+    for (int i = 0; i < 300; i++) {
+        CHECK(mac_table_insert(&table, flooder) == MAC_TABLE_RATE_LIMITED);
+    }
+    background(4000, 100);
+    check_top(flooder, 300);
+
+    // Lookup hits and refreshes of a resident MAC count too
+    CHECK(mac_table_set_admission_control(&table, NULL));
+    for (int i = 0; i < 400; i++) {
+        CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_UPDATED);
+    }
+    check_top(mac, 801);
+
+    CHECK(mac_table_enable_heavy_hitters(&table, NULL, 0));
+    CHECK(mac_table_get_heavy_hitters(&table, counters, 8) == 0);
+
+    return test_report("test_heavy_hitters");
+}
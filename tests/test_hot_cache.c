@@ -0,0 +1,89 @@
+/* Host tests for the hot-entry cache: it must never change an answer, even
+ * across deletes, slot reuse and slot generation wrap-around. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+#define KEYS 48
+
+static mac_entry_t entries[64];
+static mac_table_t table;
+static mac_hot_cache_line_t lines[8];
+
+static mac_entry_t single_entry[1];
+static mac_table_t single;
+static mac_hot_cache_line_t single_lines[4];
+
+static void make_mac(uint16_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[0] = 0x89;
+    mac[MAC_ADDR_LEN - 2] = (uint8_t)(id >> 8);
+    mac[MAC_ADDR_LEN - 1] = (uint8_t)id;
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 64, 1000, NULL));
+    CHECK(!mac_table_enable_hot_cache(&table, lines, 6));
+    CHECK(mac_table_enable_hot_cache(&table, lines, 8));
+
+    // Random traffic over more keys than lines, checked against a reference
+    bool present[KEYS] = {false};
+    for (int op = 0; op < 20000; op++) {
+        uint16_t id = (uint16_t)(test_rand() % KEYS * 37);
+        bool *expected = &present[id / 37];
+        make_mac(id, mac);
+        switch (test_rand() % 4) {
+        case 0:
+            CHECK(mac_table_insert(&table, mac) == (*expected ? MAC_TABLE_UPDATED : MAC_TABLE_INSERTED));
+            *expected = true;
+            break;
+        case 1:
+            CHECK(mac_table_delete(&table, mac) == (*expected ? MAC_TABLE_DELETED : MAC_TABLE_NOT_FOUND));
+            *expected = false;
+            break;
+        case 2:
+            CHECK(mac_table_touch(&table, mac) == (*expected ? MAC_TABLE_UPDATED : MAC_TABLE_NOT_FOUND));
+            break;
+        default:
+            CHECK(mac_table_exists(&table, mac) == (*expected ? MAC_TABLE_OK : MAC_TABLE_NOT_FOUND));
+            break;
+        }
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < KEYS; i++) {
+        count += present[i];
+    }
+    CHECK(table.stats->active_entries == count);
+
+    // Disabling falls back to probing with the same answers
+    CHECK(mac_table_enable_hot_cache(&table, NULL, 0));
+    for (uint16_t i = 0; i < KEYS; i++) {
+        make_mac(i * 37, mac);
+        CHECK(mac_table_exists(&table, mac) == (present[i] ? MAC_TABLE_OK : MAC_TABLE_NOT_FOUND));
+    }
+
+    // A one-slot table reuses the same slot until its generation wraps; the
+    // stale line for the first MAC must still miss
+    uint8_t first[MAC_ADDR_LEN], other[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&single, single_entry, 1, 1000, NULL));
+    CHECK(mac_table_enable_hot_cache(&single, single_lines, 4));
+    make_mac(1, first);
+    make_mac(2, other); // Another line, so the first one is kept
+    CHECK(mac_table_insert(&single, first) == MAC_TABLE_INSERTED);
+    CHECK(mac_table_exists(&single, first) == MAC_TABLE_OK);
+    CHECK(mac_table_delete(&single, first) == MAC_TABLE_DELETED);
+    for (uint32_t reuse = 1; reuse < (1u << (8 * sizeof(mac_slot_generation_t))); reuse++) {
+        CHECK(mac_table_insert(&single, other) == MAC_TABLE_INSERTED);
+        CHECK(mac_table_delete(&single, other) == MAC_TABLE_DELETED);
+    }
+    CHECK(single_entry[0].generation == 0);
+    CHECK(mac_table_insert(&single, other) == MAC_TABLE_INSERTED);
+    CHECK(mac_table_exists(&single, first) == MAC_TABLE_NOT_FOUND);
+    CHECK(mac_table_delete(&single, first) == MAC_TABLE_NOT_FOUND);
+    CHECK(mac_table_exists(&single, other) == MAC_TABLE_OK);
+
+    return test_report("test_hot_cache");
+}
@@ -0,0 +1,108 @@
+/* Host tests for the locally administered partition: randomized MACs are
+ * capped and short-lived, globally unique MACs are unaffected. Other key
+ * widths have no locally administered bit and refuse the partition. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_entry_t entries[16];
+static mac_table_t table;
+
+#if MAC_ADDR_LEN == 6
+static void make_mac(uint8_t id, bool local_admin, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[0] = local_admin ? MAC_ADDR_LOCAL_ADMIN_BIT : 0;
+    mac[1] = 0x87;
+    mac[2] = id;
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 16, 100, test_record_event));
+    CHECK(!mac_table_set_la_partition(&table, 17, 20));
+    CHECK(mac_table_set_la_partition(&table, 4, 20));
+
+    // The cap rejects further randomized MACs as FULL, with no slot
+    for (uint8_t id = 1; id <= 4; id++) {
+        make_mac(id, true, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    CHECK(table.stats->la_entries == 4);
+    make_mac(5, true, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_FULL);
+    CHECK(table.stats->total_la_rejected == 1);
+    CHECK(test_count_mac_events(mac, MAC_TABLE_FULL) == 1);
+    CHECK(test_events[test_event_count - 1].slot == -1);
+    CHECK(table.stats->active_entries == 4);
+
+    // Refreshing a randomized MAC already in the table is not a new entry
+    make_mac(1, true, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_UPDATED);
+
+    // Globally unique MACs still get the rest of the table
+    for (uint8_t id = 1; id <= 12; id++) {
+        make_mac(id, false, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    CHECK(table.stats->active_entries == 16);
+    CHECK(table.stats->la_entries == 4);
+
+    // Deleting frees room in the partition
+    make_mac(2, true, mac);
+    CHECK(mac_table_delete(&table, mac) == MAC_TABLE_DELETED);
+    CHECK(table.stats->la_entries == 3);
+    make_mac(5, true, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    CHECK(table.stats->la_entries == 4);
+
+    // Randomized MACs live for the partition TTL, others for the default
+    host_advance(20);
+    CHECK(table.stats->la_entries == 0);
+    CHECK(table.stats->active_entries == 12);
+    make_mac(1, false, mac);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+
+    // A custom duration overrides the partition TTL
+    mac_insert_options_t opts = {.has_custom_duration = true, .custom_duration = 50};
+    make_mac(6, true, mac);
+    CHECK(mac_table_insert_ex(&table, mac, &opts) == MAC_TABLE_INSERTED);
+    host_advance(49);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+    host_advance(1);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    host_advance(30);
+    CHECK(table.stats->active_entries == 0);
+
+    // Without the partition randomized MACs are ordinary entries
+    CHECK(mac_table_set_la_partition(&table, 0, 0));
+    for (uint8_t id = 1; id <= 8; id++) {
+        make_mac(id, true, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    CHECK(table.stats->la_entries == 0);
+    CHECK(table.stats->total_la_rejected == 1);
+
+    return test_report("test_la_partition");
+}
+#else
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 16, 100, test_record_event));
+    CHECK(!mac_table_set_la_partition(&table, 4, 20));
+    CHECK(mac_table_set_la_partition(&table, 0, 0));
+
+    // A key whose first byte has bit 1 set is an ordinary entry
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[0] = MAC_ADDR_LOCAL_ADMIN_BIT;
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    CHECK(table.stats->la_entries == 0);
+    host_advance(99);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_OK);
+
+    return test_report("test_la_partition");
+}
+#endif
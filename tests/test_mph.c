@@ -0,0 +1,87 @@
+/* Host test for the constant allowlist generator (tools/mac_mph_gen.c).
+ *
+ * Built twice: with TEST_MPH_EMIT_KEYS it prints a deterministic key list (with
+ * a comment, a blank line and a duplicate) for the generator; otherwise it is
+ * linked against the generated `test_allow` table and checks that every key
+ * maps to its own slot and that other keys are rejected. */
+
+#include <stdlib.h>
+#include <string.h>
+#include "test_util.h"
+
+#define KEY_COUNT 1500
+
+#ifdef TEST_MPH_EMIT_KEYS
+#include "mac_mph_hash.h"
+
+int main(void)
+{
+    printf("# test allowlist\n\n");
+    uint8_t first[MAC_ADDR_LEN];
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+        uint8_t key[MAC_ADDR_LEN];
+        test_random_key(key, MAC_ADDR_LEN);
+        if (i == 0) {
+            memcpy(first, key, MAC_ADDR_LEN);
+        }
+        for (size_t b = 0; b < MAC_ADDR_LEN; b++) {
+            printf(b ? "-%02x" : "%02X", key[b]); // Both separators and cases
+        }
+        printf("\n");
+    }
+    for (size_t b = 0; b < MAC_ADDR_LEN; b++) {
+        printf(b ? ":%02X" : "%02X", first[b]);
+    }
+    printf("\n");
+    return 0;
+}
+#else
+#include "mac_mph.h"
+
+extern const mac_mph_t test_allow;
+
+static int compare_keys(const void *a, const void *b)
+{
+    return memcmp(a, b, MAC_ADDR_LEN);
+}
+
+int main(void)
+{
+    static uint8_t keys[KEY_COUNT][MAC_ADDR_LEN];
+    static bool slot_used[KEY_COUNT];
+
+    // Same stream as the emitter, so the keys match the generated table
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+        test_random_key(keys[i], MAC_ADDR_LEN);
+    }
+    qsort(keys, KEY_COUNT, MAC_ADDR_LEN, compare_keys);
+    size_t unique = 0;
+    for (size_t i = 0; i < KEY_COUNT; i++) {
+        if (unique == 0 || memcmp(keys[unique - 1], keys[i], MAC_ADDR_LEN) != 0) {
+            memcpy(keys[unique++], keys[i], MAC_ADDR_LEN);
+        }
+    }
+
+    CHECK(test_allow.key_count == unique);
+    for (size_t i = 0; i < unique; i++) {
+        int slot = mac_mph_find(&test_allow, keys[i]);
+        CHECK(slot >= 0 && (size_t)slot < test_allow.key_count);
+        if (slot >= 0 && (size_t)slot < KEY_COUNT) {
+            CHECK(!slot_used[slot]);
+            slot_used[slot] = true;
+        }
+        CHECK(mac_mph_exists(&test_allow, keys[i]) == MAC_TABLE_OK);
+    }
+
+    // Keys outside the set: present only if the generator was given them
+    for (int i = 0; i < 200000; i++) {
+        uint8_t probe[MAC_ADDR_LEN];
+        test_random_key(probe, MAC_ADDR_LEN);
+        bool member = bsearch(probe, keys, unique, MAC_ADDR_LEN, compare_keys) != NULL;
+        CHECK((mac_mph_exists(&test_allow, probe) == MAC_TABLE_OK) == member);
+    }
+    CHECK(mac_mph_exists(&test_allow, NULL) == MAC_TABLE_NOT_FOUND);
+
+    return test_report("test_mph");
+}
+#endif
@@ -0,0 +1,187 @@
+/* Host tests for the ordered index: prefix, range and successor queries
+ * agree with a sorted scan of the table through inserts, deletes, expiry
+ * and relocation. */
+
+#include <stdlib.h>
+#include "mac_table.h"
+#include "test_util.h"
+
+#define SIZE 128
+
+static mac_entry_t entries[SIZE];
+static mac_table_t table;
+static uint64_t records[SIZE];
+static uint16_t hits[SIZE];
+
+#if MAC_ADDR_LEN <= 6
+static const uint8_t ouis[4][3] = {{0x00, 0x1A, 0x2B}, {0x00, 0x1A, 0x2C}, {0x3C, 0x00, 0x00}, {0xF0, 0xFF, 0xFF}};
+
+static void random_mac(uint8_t *mac)
+{
+    test_random_key(mac, MAC_ADDR_LEN);
+    memcpy(mac, ouis[test_rand() % 4], 3);
+    if (MAC_ADDR_LEN > 3) {
+        mac[3] &= 0x0F; // Few distinct suffixes, so ranges have ties nearby
+    }
+}
+
+static int compare_keys(const void *a, const void *b)
+{
+    return memcmp(a, b, MAC_ADDR_LEN);
+}
+
+// Sorted MACs of the table with first <= MAC <= last (NULL bounds are open)
+static size_t scan(const uint8_t *first, const uint8_t *last, uint8_t (*out)[MAC_ADDR_LEN])
+{
+    size_t count = 0;
+    for (size_t i = 0; i < SIZE; i++) {
+        if (entries[i].state != SLOT_OCCUPIED) {
+            continue;
+        }
+        mac_table_entry_mac(&table, &entries[i], out[count]);
+        if ((!first || memcmp(out[count], first, MAC_ADDR_LEN) >= 0) &&
+            (!last || memcmp(out[count], last, MAC_ADDR_LEN) <= 0)) {
+            count++;
+        }
+    }
+    qsort(out, count, MAC_ADDR_LEN, compare_keys);
+    return count;
+}
+
+// The slots returned hold exactly `expected`, in order
+static bool slots_match(const size_t *slots, size_t n, uint8_t (*expected)[MAC_ADDR_LEN], size_t count)
+{
+    if (n != count) {
+        return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint8_t mac[MAC_ADDR_LEN];
+        if (entries[slots[i]].state != SLOT_OCCUPIED) {
+            return false;
+        }
+        mac_table_entry_mac(&table, &entries[slots[i]], mac);
+        if (memcmp(mac, expected[i], MAC_ADDR_LEN) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_queries(void)
+{
+    static uint8_t expected[SIZE][MAC_ADDR_LEN];
+    size_t slots[SIZE];
+
+    // A full range is a sorted dump; find_next walks the same order
+    uint8_t low[MAC_ADDR_LEN], high[MAC_ADDR_LEN];
+    memset(low, 0x00, MAC_ADDR_LEN);
+    memset(high, 0xFF, MAC_ADDR_LEN);
+    size_t count = scan(NULL, NULL, expected);
+    CHECK(slots_match(slots, mac_table_find_range(&table, low, high, slots, SIZE), expected, count));
+    const uint8_t *prev = NULL;
+    uint8_t mac[MAC_ADDR_LEN];
+    for (size_t i = 0; i <= count; i++) {
+        int slot = mac_table_find_next(&table, prev);
+        if (i == count) {
+            CHECK(slot == -1);
+            break;
+        }
+        CHECK(slot >= 0);
+        if (slot < 0) {
+            break;
+        }
+        mac_table_entry_mac(&table, &entries[slot], mac);
+        CHECK(memcmp(mac, expected[i], MAC_ADDR_LEN) == 0);
+        prev = mac;
+    }
+
+    // Truncated output keeps the smallest MACs
+    if (count >= 3) {
+        CHECK(slots_match(slots, mac_table_find_range(&table, low, high, slots, 3), expected, 3));
+    }
+
+    // Every vendor prefix
+    for (size_t o = 0; o < 4; o++) {
+        memcpy(low, ouis[o], 3);
+        memset(low + 3, 0x00, MAC_ADDR_LEN - 3);
+        memcpy(high, ouis[o], 3);
+        memset(high + 3, 0xFF, MAC_ADDR_LEN - 3);
+        count = scan(low, high, expected);
+        CHECK(slots_match(slots, mac_table_find_by_oui(&table, ouis[o], slots, SIZE), expected, count));
+    }
+
+    // Random ranges, bounds drawn from both present and absent MACs
+    for (int r = 0; r < 50; r++) {
+        random_mac(low);
+        random_mac(high);
+        if (memcmp(low, high, MAC_ADDR_LEN) > 0) {
+            memcpy(mac, low, MAC_ADDR_LEN);
+            memcpy(low, high, MAC_ADDR_LEN);
+            memcpy(high, mac, MAC_ADDR_LEN);
+        }
+        count = scan(low, high, expected);
+        CHECK(slots_match(slots, mac_table_find_range(&table, low, high, slots, SIZE), expected, count));
+        if (memcmp(low, high, MAC_ADDR_LEN) < 0) {
+            CHECK(mac_table_find_range(&table, high, low, slots, SIZE) == 0);
+        }
+    }
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, SIZE, 100, NULL));
+
+    // Entries already present are indexed when the index is enabled
+    for (int i = 0; i < 40; i++) {
+        random_mac(mac);
+        mac_table_insert(&table, mac);
+    }
+    CHECK(mac_table_enable_ordered_index(&table, records));
+    check_queries();
+
+    // Churn with inserts, deletes and expiry
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 30; i++) {
+            random_mac(mac);
+            if (test_rand() % 3) {
+                mac_table_insert(&table, mac);
+            } else {
+                mac_table_delete(&table, mac);
+            }
+        }
+        host_advance(10);
+        check_queries();
+    }
+
+    // Relocation keeps records pointing at the moved entries
+    CHECK(mac_table_enable_hit_counters(&table, hits));
+    for (size_t i = 0; i < SIZE; i++) {
+        if (entries[i].state == SLOT_OCCUPIED) {
+            mac_table_entry_mac(&table, &entries[i], mac);
+            for (uint32_t n = test_rand() % 8; n > 0; n--) {
+                mac_table_exists(&table, mac);
+            }
+        }
+    }
+    mac_table_relocate_hot(&table);
+    check_queries();
+
+    // Disabled, queries report nothing
+    size_t slots[4];
+    CHECK(mac_table_enable_ordered_index(&table, NULL));
+    CHECK(mac_table_find_by_oui(&table, ouis[0], slots, 4) == 0);
+    CHECK(mac_table_find_next(&table, NULL) == -1);
+
+    return test_report("test_ordered_index");
+}
+#else
+int main(void)
+{
+    // Records pack the MAC into 48 bits; wider keys are refused
+    CHECK(mac_table_init(&table, entries, SIZE, 100, NULL));
+    CHECK(!mac_table_enable_ordered_index(&table, records));
+    (void)hits;
+    return test_report("test_ordered_index");
+}
+#endif
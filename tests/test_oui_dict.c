@@ -0,0 +1,137 @@
+/* Host tests for compressed keys: MACs round-trip through the OUI dictionary,
+ * a full dictionary rejects new vendors only, ids are recycled, and tables
+ * can share one dictionary. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+#ifndef MAC_TABLE_OUI_COMPRESSION
+#error "test_oui_dict needs MAC_TABLE_OUI_COMPRESSION"
+#endif
+
+#define OUIS 200
+#define NICS 2
+
+static mac_entry_t entries[512];
+static mac_table_t table;
+static mac_entry_t shared_entries[2][16];
+static mac_table_t shared_tables[2];
+static mac_oui_dict_t shared_dict;
+
+static void make_mac(uint16_t oui, uint32_t nic, uint8_t *mac)
+{
+    mac[0] = 0x95;
+    mac[1] = (uint8_t)(oui >> 8);
+    mac[2] = (uint8_t)oui;
+    mac[3] = (uint8_t)(nic >> 16);
+    mac[4] = (uint8_t)(nic >> 8);
+    mac[5] = (uint8_t)nic;
+}
+
+static bool round_trips(const mac_table_t *t, int slot, const uint8_t *mac)
+{
+    mac_entry_t copy;
+    uint8_t stored[MAC_ADDR_LEN];
+    if (slot < 0 || mac_table_get_by_index(t, (size_t)slot, &copy) != MAC_TABLE_OK) {
+        return false;
+    }
+    mac_table_entry_mac(t, &copy, stored);
+    return memcmp(stored, mac, MAC_ADDR_LEN) == 0;
+}
+
+static int last_slot(void)
+{
+    return test_events[test_event_count - 1].slot;
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(sizeof(mac_entry_t) == (sizeof(time_t) == 8 ? 24 : 16));
+    CHECK(mac_table_init(&table, entries, 512, 100, test_record_event));
+
+    // One entry per vendor fills the dictionary; only new vendors are refused
+    for (uint16_t oui = 0; oui < MAC_TABLE_OUI_DICT_SIZE; oui++) {
+        make_mac(oui, 0xA00000u | oui, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+        CHECK(round_trips(&table, last_slot(), mac));
+    }
+    make_mac(1000, 1, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_FULL);
+    CHECK(last_slot() == -1);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    CHECK(table.stats->active_entries == MAC_TABLE_OUI_DICT_SIZE);
+    CHECK(table.stats->total_inserts == MAC_TABLE_OUI_DICT_SIZE);
+    make_mac(3, 0xFFFFFF, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    CHECK(round_trips(&table, last_slot(), mac));
+
+    // An id is recycled once its last entry is deleted or expires
+    make_mac(5, 0xA00005, mac);
+    CHECK(mac_table_delete(&table, mac) == MAC_TABLE_DELETED);
+    make_mac(1000, 1, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    CHECK(round_trips(&table, last_slot(), mac));
+    make_mac(5, 0xA00005, mac);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+
+    make_mac(7, 0xA00007, mac);
+    mac_insert_options_t opts = {.has_custom_duration = true, .custom_duration = 1};
+    CHECK(mac_table_insert_ex(&table, mac, &opts) == MAC_TABLE_UPDATED);
+    host_advance(1);
+    CHECK(mac_table_exists(&table, mac) == MAC_TABLE_NOT_FOUND);
+    make_mac(1001, 1, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    CHECK(round_trips(&table, last_slot(), mac));
+
+    // Churn that keeps freeing and reusing ids, checked against a reference
+    CHECK(mac_table_clear(&table) == MAC_TABLE_OUI_DICT_SIZE + 1);
+    bool present[OUIS][NICS] = {{false}};
+    for (int op = 0; op < 20000; op++) {
+        uint16_t oui = (uint16_t)(test_rand() % OUIS * 101);
+        uint32_t nic = test_rand() % NICS;
+        bool *expected = &present[oui / 101][nic];
+        make_mac(oui, nic, mac);
+        test_clear_events();
+        if (test_rand() % 2) {
+            CHECK(mac_table_insert(&table, mac) == (*expected ? MAC_TABLE_UPDATED : MAC_TABLE_INSERTED));
+            CHECK(round_trips(&table, last_slot(), mac));
+            *expected = true;
+        } else {
+            CHECK(mac_table_delete(&table, mac) == (*expected ? MAC_TABLE_DELETED : MAC_TABLE_NOT_FOUND));
+            *expected = false;
+        }
+    }
+    for (uint16_t i = 0; i < OUIS; i++) {
+        for (uint32_t nic = 0; nic < NICS; nic++) {
+            make_mac((uint16_t)(i * 101), nic, mac);
+            CHECK(mac_table_exists(&table, mac) == (present[i][nic] ? MAC_TABLE_OK : MAC_TABLE_NOT_FOUND));
+        }
+    }
+
+    // Two tables on one dictionary share ids and keep each other's alive
+    mac_table_t *a = &shared_tables[0], *b = &shared_tables[1];
+    uint8_t mac_a[MAC_ADDR_LEN], mac_b[MAC_ADDR_LEN];
+    CHECK(mac_table_init(a, shared_entries[0], 16, 100, test_record_event));
+    CHECK(mac_table_init(b, shared_entries[1], 16, 100, test_record_event));
+    CHECK(!mac_table_share_oui_dict(a, NULL));
+    CHECK(mac_table_share_oui_dict(a, &shared_dict));
+    CHECK(mac_table_share_oui_dict(b, &shared_dict));
+    make_mac(42, 1, mac_a);
+    make_mac(42, 2, mac_b);
+    CHECK(mac_table_insert(a, mac_a) == MAC_TABLE_INSERTED);
+    int slot_a = last_slot();
+    CHECK(mac_table_insert(b, mac_b) == MAC_TABLE_INSERTED);
+    int slot_b = last_slot();
+    CHECK(shared_entries[0][slot_a].key >> 24 == shared_entries[1][slot_b].key >> 24);
+    CHECK(mac_table_delete(a, mac_a) == MAC_TABLE_DELETED);
+    make_mac(43, 1, mac);
+    CHECK(mac_table_insert(a, mac) == MAC_TABLE_INSERTED);
+    CHECK(round_trips(a, last_slot(), mac));
+    CHECK(round_trips(b, slot_b, mac_b));
+    CHECK(mac_table_exists(b, mac_b) == MAC_TABLE_OK);
+    CHECK(!mac_table_share_oui_dict(a, &shared_dict)); // Not empty
+
+    return test_report("test_oui_dict");
+}
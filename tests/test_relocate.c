@@ -0,0 +1,103 @@
+/* Host tests for hot-entry relocation: a frequently hit entry moves toward
+ * its home slot, every MAC stays reachable, and deadlines follow the moves. */
+
+#include "mac_table.h"
+#include "mac_table_internal.h"
+#include "test_events.h"
+#include "test_util.h"
+
+#define SIZE 32
+#define FILL 28
+
+static mac_entry_t entries[SIZE];
+static mac_table_t table;
+static uint16_t hits[SIZE];
+static mac_hot_cache_line_t lines[8];
+static uint8_t macs[FILL][MAC_ADDR_LEN];
+
+static size_t distance(const uint8_t *mac, size_t slot)
+{
+    size_t home = mac_hash32(mac, 0) % SIZE;
+    return (slot + SIZE - home) % SIZE;
+}
+
+static int slot_of(const uint8_t *mac)
+{
+    for (size_t i = 0; i < SIZE; i++) {
+        uint8_t stored[MAC_ADDR_LEN];
+        if (entries[i].state == SLOT_OCCUPIED) {
+            mac_table_entry_mac(&table, &entries[i], stored);
+            if (memcmp(stored, mac, MAC_ADDR_LEN) == 0) {
+                return (int)i;
+            }
+        }
+    }
+    return -1;
+}
+
+int main(void)
+{
+    CHECK(mac_table_init(&table, entries, SIZE, 100, test_record_event));
+    CHECK(mac_table_enable_hot_cache(&table, lines, 8));
+    CHECK(mac_table_relocate_hot(&table) == 0); // No counters yet
+    CHECK(mac_table_enable_hit_counters(&table, hits));
+
+    for (size_t i = 0; i < FILL; i++) {
+        do {
+            test_random_key(macs[i], MAC_ADDR_LEN);
+        } while (mac_table_exists(&table, macs[i]) == MAC_TABLE_OK);
+        CHECK(mac_table_insert(&table, macs[i]) == MAC_TABLE_INSERTED);
+    }
+
+    // The entry furthest from home is the hot one
+    size_t hot = 0;
+    int hot_slot = slot_of(macs[0]);
+    for (size_t i = 1; i < FILL; i++) {
+        int slot = slot_of(macs[i]);
+        if (distance(macs[i], (size_t)slot) > distance(macs[hot], (size_t)hot_slot)) {
+            hot = i;
+            hot_slot = slot;
+        }
+    }
+    CHECK(distance(macs[hot], (size_t)hot_slot) > 0);
+
+    // Give it a later deadline than everyone else, and ten more hits
+    host_advance(10);
+    CHECK(mac_table_touch(&table, macs[hot]) == MAC_TABLE_UPDATED);
+    for (int i = 0; i < 10; i++) {
+        CHECK(mac_table_exists(&table, macs[hot]) == MAC_TABLE_OK);
+    }
+    CHECK(hits[hot_slot] == 11);
+
+    size_t events = test_event_count;
+    CHECK(mac_table_relocate_hot(&table) >= 1);
+    int new_slot = slot_of(macs[hot]);
+    CHECK(new_slot >= 0 && distance(macs[hot], (size_t)new_slot) < distance(macs[hot], (size_t)hot_slot));
+    CHECK(test_count_mac_events(macs[hot], MAC_TABLE_RELOCATED) == 1);
+    for (size_t i = events; i < test_event_count; i++) {
+        CHECK(test_events[i].status == MAC_TABLE_RELOCATED);
+        CHECK(slot_of(test_events[i].mac) == test_events[i].slot);
+    }
+    CHECK(hits[new_slot] == 5); // Halved after the pass
+
+    // Everything is still found, through the cache and by probing
+    for (size_t i = 0; i < FILL; i++) {
+        CHECK(mac_table_exists(&table, macs[i]) == MAC_TABLE_OK);
+    }
+    CHECK(mac_table_enable_hot_cache(&table, NULL, 0));
+    for (size_t i = 0; i < FILL; i++) {
+        CHECK(mac_table_exists(&table, macs[i]) == MAC_TABLE_OK);
+    }
+    CHECK(table.stats->active_entries == FILL);
+
+    // Each deadline moved with its entry
+    host_advance(90);
+    CHECK(table.stats->active_entries == 1);
+    CHECK(test_count_events(MAC_TABLE_TIMEOUT) == FILL - 1);
+    CHECK(mac_table_exists(&table, macs[hot]) == MAC_TABLE_OK);
+    host_advance(10);
+    CHECK(test_count_mac_events(macs[hot], MAC_TABLE_TIMEOUT) == 1);
+    CHECK(table.stats->active_entries == 0);
+
+    return test_report("test_relocate");
+}
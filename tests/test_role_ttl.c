@@ -0,0 +1,71 @@
+/* Host tests for per-role default TTLs: the role's TTL applies unless a
+ * custom duration is given, refreshes keep the role, and the map is capped. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+static mac_entry_t entries[16];
+static mac_table_t table;
+
+static mac_entry_result_t insert_role(uint8_t id, uint8_t role, time_t custom)
+{
+    uint8_t mac[MAC_ADDR_LEN] = {0x00, 0x80, id};
+    mac_insert_options_t opts = {0};
+    opts.has_role = true;
+    opts.role = role;
+    opts.has_custom_duration = custom > 0;
+    opts.custom_duration = custom;
+    return mac_table_insert_ex(&table, mac, &opts);
+}
+
+static bool present(uint8_t id)
+{
+    uint8_t mac[MAC_ADDR_LEN] = {0x00, 0x80, id};
+    return mac_table_exists(&table, mac) == MAC_TABLE_OK;
+}
+
+int main(void)
+{
+    CHECK(mac_table_init(&table, entries, 16, 60, NULL));
+    CHECK(mac_table_set_role_ttl(&table, 1, 10));
+    CHECK(mac_table_set_role_ttl(&table, 2, 300));
+
+    CHECK(insert_role(1, 1, 0) == MAC_TABLE_INSERTED);  // Role 1: 10 s
+    CHECK(insert_role(2, 2, 0) == MAC_TABLE_INSERTED);  // Role 2: 300 s
+    CHECK(insert_role(3, 7, 0) == MAC_TABLE_INSERTED);  // No override: 60 s
+    CHECK(insert_role(4, 1, 30) == MAC_TABLE_INSERTED); // Custom beats role
+    uint8_t plain[MAC_ADDR_LEN] = {0x00, 0x80, 5};
+    CHECK(mac_table_insert(&table, plain) == MAC_TABLE_INSERTED); // Role 0: 60 s
+
+    host_advance(9);
+    CHECK(present(1));
+    host_advance(1);
+    CHECK(!present(1) && present(4));
+
+    // A refresh without a role keeps the entry's role, and so its TTL
+    uint8_t role2[MAC_ADDR_LEN] = {0x00, 0x80, 2};
+    CHECK(mac_table_insert(&table, role2) == MAC_TABLE_UPDATED);
+    host_advance(20);
+    CHECK(!present(4) && present(3));
+    host_advance(30);
+    CHECK(!present(3) && !present(5) && present(2));
+    host_advance(10 + 300 - 60 - 1); // Refreshed at +10
+    CHECK(present(2));
+    host_advance(1);
+    CHECK(!present(2));
+
+    // Dropping an override restores the default; the map holds eight roles
+    CHECK(mac_table_set_role_ttl(&table, 1, 0));
+    CHECK(insert_role(6, 1, 0) == MAC_TABLE_INSERTED);
+    host_advance(59);
+    CHECK(present(6));
+    host_advance(1);
+    CHECK(!present(6));
+    for (uint8_t role = 10; role < 10 + MAC_TABLE_MAX_ROLE_TTLS - 1; role++) {
+        CHECK(mac_table_set_role_ttl(&table, role, 5));
+    }
+    CHECK(!mac_table_set_role_ttl(&table, 99, 5));
+    CHECK(mac_table_set_role_ttl(&table, 2, 45)); // Updating an existing role still works
+
+    return test_report("test_role_ttl");
+}
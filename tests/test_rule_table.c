@@ -0,0 +1,139 @@
+/* Host tests for the masked rule table: priority and tie resolution, and
+ * agreement between the compiled lookup and a plain scan of the rules. */
+
+#include <string.h>
+#include "mac_rule_table.h"
+#include "test_util.h"
+
+#define MAX_RULES 64
+
+typedef struct {
+    uint8_t mac[MAC_ADDR_LEN];
+    uint8_t mask[MAC_ADDR_LEN];
+    uint8_t priority;
+    uint8_t action;
+} ref_rule_t;
+
+static ref_rule_t ref_rules[MAX_RULES];
+static size_t ref_count;
+
+static bool add_rule(mac_rule_table_t *rules, const uint8_t *mac, const uint8_t *mask, uint8_t priority,
+                     uint8_t action)
+{
+    ref_rule_t *ref = &ref_rules[ref_count++];
+    memcpy(ref->mac, mac, MAC_ADDR_LEN);
+    memcpy(ref->mask, mask, MAC_ADDR_LEN);
+    ref->priority = priority;
+    ref->action = action;
+    return mac_rule_table_add(rules, mac, mask, priority, action);
+}
+
+// Specification: highest priority wins, then the rule added first
+static mac_entry_result_t ref_match(const uint8_t *mac, uint8_t *action)
+{
+    const ref_rule_t *best = NULL;
+    for (size_t r = 0; r < ref_count; r++) {
+        bool hit = true;
+        for (size_t i = 0; i < MAC_ADDR_LEN && hit; i++) {
+            hit = (mac[i] & ref_rules[r].mask[i]) == (ref_rules[r].mac[i] & ref_rules[r].mask[i]);
+        }
+        if (hit && (!best || ref_rules[r].priority > best->priority)) {
+            best = &ref_rules[r];
+        }
+    }
+    if (!best) {
+        return MAC_TABLE_NOT_FOUND;
+    }
+    *action = best->action;
+    return MAC_TABLE_OK;
+}
+
+static uint8_t match_action(const mac_rule_table_t *rules, const uint8_t *mac)
+{
+    uint8_t action = 0xEE;
+    return mac_rule_table_match(rules, mac, &action) == MAC_TABLE_OK ? action : 0xFF;
+}
+
+static void test_priorities(void)
+{
+    uint8_t any[MAC_ADDR_LEN] = {0};
+    uint8_t prefix_mask[MAC_ADDR_LEN] = {0xFF, 0xFF, 0xFF};
+    uint8_t exact_mask[MAC_ADDR_LEN];
+    uint8_t vendor[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B};
+    uint8_t vendor_host[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x01};
+    uint8_t vendor_other[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2B, 0x02};
+    uint8_t stranger[MAC_ADDR_LEN] = {0x00, 0x1A, 0x2C, 0x01};
+    memset(exact_mask, 0xFF, sizeof(exact_mask));
+
+    mac_rule_table_t *rules = mac_rule_table_create(8);
+    CHECK(rules != NULL);
+    CHECK(mac_rule_table_match(rules, vendor_host, NULL) == MAC_TABLE_NOT_FOUND);
+
+    CHECK(mac_rule_table_add(rules, any, any, 0, MAC_RULE_DENY));
+    CHECK(mac_rule_table_add(rules, vendor, prefix_mask, 10, MAC_RULE_ALLOW));
+    CHECK(mac_rule_table_add(rules, vendor_host, exact_mask, 20, MAC_RULE_DENY));
+    CHECK(mac_rule_table_add(rules, vendor, prefix_mask, 10, 7)); // Same rule, added later: loses the tie
+
+    for (int pass = 0; pass < 2; pass++) {
+        CHECK(match_action(rules, vendor_host) == MAC_RULE_DENY);
+        CHECK(match_action(rules, vendor_other) == MAC_RULE_ALLOW);
+        CHECK(match_action(rules, stranger) == MAC_RULE_DENY);
+        CHECK(mac_rule_table_compile(rules));
+    }
+
+    // Rules added after compiling are honoured before the next compile
+    uint8_t stranger_mask[MAC_ADDR_LEN] = {0xFF, 0xFF, 0xFF};
+    CHECK(mac_rule_table_add(rules, stranger, stranger_mask, 30, 9));
+    CHECK(match_action(rules, stranger) == 9);
+    CHECK(mac_rule_table_compile(rules));
+    CHECK(match_action(rules, stranger) == 9);
+
+    mac_rule_table_free(rules);
+}
+
+static void test_against_reference(void)
+{
+    mac_rule_table_t *rules = mac_rule_table_create(MAX_RULES);
+    CHECK(rules != NULL);
+    ref_count = 0;
+
+    // Four masks (default, 1-byte, 2-byte nibble, exact) over a narrow address
+    // space, so rules overlap and tie
+    static const uint8_t mask_byte[] = {0x00, 0xFF, 0xF0, 0xFF};
+    static const size_t mask_len[] = {0, 1, 2, MAC_ADDR_LEN};
+    for (size_t r = 0; r < MAX_RULES; r++) {
+        uint8_t mac[MAC_ADDR_LEN];
+        uint8_t mask[MAC_ADDR_LEN];
+        size_t kind = test_rand() % 4;
+        for (size_t i = 0; i < MAC_ADDR_LEN; i++) {
+            mac[i] = (uint8_t)(test_rand() & 0x11);
+            mask[i] = i < mask_len[kind] ? mask_byte[kind] : 0x00;
+        }
+        CHECK(add_rule(rules, mac, mask, (uint8_t)(test_rand() % 4), (uint8_t)r));
+    }
+    CHECK(!mac_rule_table_add(rules, ref_rules[0].mac, ref_rules[0].mask, 0, 0)); // Full
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < 5000; i++) {
+            uint8_t mac[MAC_ADDR_LEN];
+            for (size_t b = 0; b < MAC_ADDR_LEN; b++) {
+                mac[b] = (uint8_t)(test_rand() & 0x11);
+            }
+            uint8_t expected = 0xFF;
+            uint8_t got = 0xFF;
+            mac_entry_result_t want = ref_match(mac, &expected);
+            CHECK(mac_rule_table_match(rules, mac, &got) == want);
+            CHECK(got == expected);
+        }
+        CHECK(mac_rule_table_compile(rules));
+    }
+
+    mac_rule_table_free(rules);
+}
+
+int main(void)
+{
+    test_priorities();
+    test_against_reference();
+    return test_report("test_rule_table");
+}
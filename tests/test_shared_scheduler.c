@@ -0,0 +1,121 @@
+/* Host tests for tables sharing one expiry scheduler: every table's entries
+ * expire on time from the merged heap, the heap holds every slot of every
+ * table, and detaching one table leaves nothing of it behind. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+#define TABLE_SIZE 16
+
+static size_t expired_a;
+static size_t expired_b;
+static size_t other_a;
+
+static void on_event_a(int slot, const uint8_t *mac, mac_entry_result_t status)
+{
+    (void)slot, (void)mac;
+    if (status == MAC_TABLE_TIMEOUT) {
+        expired_a++;
+    } else if (status != MAC_TABLE_INSERTED) {
+        other_a++;
+    }
+}
+
+static void on_event_b(int slot, const uint8_t *mac, mac_entry_result_t status)
+{
+    (void)slot, (void)mac;
+    expired_b += status == MAC_TABLE_TIMEOUT;
+}
+
+static void insert_random(mac_table_t *table, uint8_t tag, time_t max_ttl)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    test_random_key(mac, MAC_ADDR_LEN);
+    mac[0] = tag;
+    mac_insert_options_t opts = {0};
+    opts.has_custom_duration = true;
+    opts.custom_duration = 1 + (time_t)(test_rand() % max_ttl);
+    CHECK(mac_table_insert_ex(table, mac, &opts) == MAC_TABLE_INSERTED);
+}
+
+// Detach one table while both have deadlines interleaved in the heap
+static void test_free_one_table(void)
+{
+    for (int trial = 0; trial < 200; trial++) {
+        static mac_entry_t entries_a[TABLE_SIZE];
+        static mac_entry_t entries_b[TABLE_SIZE];
+        mac_table_t a;
+        mac_table_t b;
+        mac_expiry_scheduler_t *scheduler = mac_expiry_scheduler_create(4);
+        CHECK(scheduler != NULL);
+        CHECK(mac_table_init_shared(&a, entries_a, TABLE_SIZE, 60, on_event_a, scheduler));
+        CHECK(mac_table_init_shared(&b, entries_b, TABLE_SIZE, 60, on_event_b, scheduler));
+
+        size_t count_a = 1 + test_rand() % (TABLE_SIZE - 1);
+        size_t count_b = 1 + test_rand() % (TABLE_SIZE - 1);
+        for (size_t i = 0; i < count_a || i < count_b; i++) {
+            if (i < count_a) {
+                insert_random(&a, 0xA0, 40);
+            }
+            if (i < count_b) {
+                insert_random(&b, 0xB0, 40);
+            }
+        }
+        host_advance(test_rand() % 5);
+        size_t expired_before = expired_a;
+
+        expiry_manager_free(a.expiry_manager);
+        a.expiry_manager = NULL;
+        host_advance(45);
+
+        // A detached manager's deadlines must be gone, not popped later
+        CHECK(expired_a == expired_before);
+        CHECK(other_a == 0);
+        CHECK(b.stats->active_entries == 0);
+        CHECK(b.stats->total_expired == count_b);
+
+        expiry_manager_free(b.expiry_manager);
+        mac_expiry_scheduler_free(scheduler);
+        expired_b = 0;
+    }
+}
+
+// Tables registered after the scheduler was created still fit in its heap
+static void test_heap_holds_every_slot(void)
+{
+    static mac_entry_t entries[3][32];
+    mac_table_t tables[3];
+    mac_expiry_scheduler_t *scheduler = mac_expiry_scheduler_create(0);
+    CHECK(scheduler != NULL);
+
+    for (size_t t = 0; t < 3; t++) {
+        CHECK(mac_table_init_shared(&tables[t], entries[t], 32, 10 + (uint32_t)t, on_event_b, scheduler));
+        for (size_t i = 0; i < 32; i++) {
+            uint8_t mac[MAC_ADDR_LEN] = {(uint8_t)t, (uint8_t)i, 0x5A};
+            CHECK(mac_table_insert(&tables[t], mac) == MAC_TABLE_INSERTED);
+        }
+        CHECK(tables[t].stats->active_entries == 32);
+    }
+
+    expired_b = 0;
+    host_advance(9);
+    CHECK(expired_b == 0);
+    for (size_t t = 0; t < 3; t++) {
+        host_advance(1);
+        CHECK(expired_b == 32 * (t + 1)); // Each table expires on its own TTL
+        CHECK(tables[t].stats->active_entries == 0);
+        CHECK(tables[t].stats->total_inserts == 32 && tables[t].stats->total_deletes == 0);
+    }
+
+    for (size_t t = 0; t < 3; t++) {
+        expiry_manager_free(tables[t].expiry_manager);
+    }
+    mac_expiry_scheduler_free(scheduler);
+}
+
+int main(void)
+{
+    test_free_one_table();
+    test_heap_holds_every_slot();
+    return test_report("test_shared_scheduler");
+}
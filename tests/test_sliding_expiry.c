@@ -0,0 +1,104 @@
+/* Host tests for sliding expiry: only a lookup hit keeps an entry alive past
+ * its deadline, and the extension is the lifetime the entry was given. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_entry_t entries[16];
+static mac_table_t table;
+
+static void make_mac(uint8_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[1] = 0x83;
+    mac[2] = id;
+}
+
+static mac_entry_result_t insert_for(const uint8_t *mac, time_t seconds)
+{
+    mac_insert_options_t opts = {.has_custom_duration = true, .custom_duration = seconds};
+    return mac_table_insert_ex(&table, mac, &opts);
+}
+
+static bool timed_out(const uint8_t *mac)
+{
+    return test_count_mac_events(mac, MAC_TABLE_TIMEOUT) > 0;
+}
+
+int main(void)
+{
+    uint8_t a[MAC_ADDR_LEN], b[MAC_ADDR_LEN], c[MAC_ADDR_LEN], d[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 16, 100, test_record_event));
+    CHECK(mac_table_set_sliding_expiry(&table, true));
+
+    // Without lookups a short custom lifetime is honoured
+    make_mac(1, a);
+    CHECK(insert_for(a, 1) == MAC_TABLE_INSERTED);
+    host_advance(2);
+    CHECK(timed_out(a));
+    CHECK(mac_table_exists(&table, a) == MAC_TABLE_NOT_FOUND);
+
+    // A hit extends by the entry's own lifetime, counted from the hit
+    make_mac(2, b);
+    CHECK(insert_for(b, 20) == MAC_TABLE_INSERTED);
+    host_advance(10);
+    CHECK(mac_table_exists(&table, b) == MAC_TABLE_OK);
+    host_advance(19);
+    CHECK(!timed_out(b));
+    host_advance(1);
+    CHECK(timed_out(b)); // No second hit, so no second extension
+
+    // The default TTL, with the last of several hits counting
+    make_mac(3, c);
+    CHECK(mac_table_insert(&table, c) == MAC_TABLE_INSERTED);
+    host_advance(50);
+    CHECK(mac_table_exists(&table, c) == MAC_TABLE_OK);
+    host_advance(40);
+    CHECK(mac_table_exists(&table, c) == MAC_TABLE_OK);
+    host_advance(99);
+    CHECK(!timed_out(c));
+    host_advance(1);
+    CHECK(timed_out(c));
+
+    // A refresh after a hit restarts the lifetime and forgets the hit
+    CHECK(insert_for(c, 30) == MAC_TABLE_INSERTED);
+    host_advance(5);
+    CHECK(mac_table_exists(&table, c) == MAC_TABLE_OK);
+    host_advance(1);
+    CHECK(insert_for(c, 10) == MAC_TABLE_UPDATED);
+    host_advance(9);
+    CHECK(test_count_mac_events(c, MAC_TABLE_TIMEOUT) == 1);
+    host_advance(1);
+    CHECK(test_count_mac_events(c, MAC_TABLE_TIMEOUT) == 2);
+
+    // With sliding expiry off, hits do not extend
+    CHECK(mac_table_set_sliding_expiry(&table, false));
+    make_mac(4, d);
+    CHECK(insert_for(d, 10) == MAC_TABLE_INSERTED);
+    host_advance(5);
+    CHECK(mac_table_exists(&table, d) == MAC_TABLE_OK);
+    host_advance(5);
+    CHECK(timed_out(d));
+    CHECK(mac_table_set_sliding_expiry(&table, true));
+
+    // A hit during the stale stage revives the entry when the stage ends
+    CHECK(mac_table_set_stale_timeout(&table, 30));
+    CHECK(insert_for(d, 10) == MAC_TABLE_INSERTED);
+    host_advance(10);
+    CHECK(test_count_mac_events(d, MAC_TABLE_STALE) == 1);
+    CHECK(table.stats->stale_entries == 1);
+    host_advance(25);
+    CHECK(mac_table_exists(&table, d) == MAC_TABLE_OK);
+    host_advance(5);
+    CHECK(table.stats->stale_entries == 0);
+    CHECK(test_count_mac_events(d, MAC_TABLE_TIMEOUT) == 1);
+    host_advance(4);
+    CHECK(mac_table_exists(&table, d) == MAC_TABLE_OK); // Hit at +44
+    host_advance(1);
+    CHECK(table.stats->stale_entries == 0); // Extended to +54 rather than staled at +45
+    host_advance(9);
+    CHECK(test_count_mac_events(d, MAC_TABLE_STALE) == 2);
+
+    return test_report("test_sliding_expiry");
+}
@@ -0,0 +1,100 @@
+/* Host tests for the stale aging stage: active -> stale -> gone, with a
+ * refresh or touch reviving a stale entry in place. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_entry_t entries[8];
+static mac_table_t table;
+
+static void make_mac(uint8_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[1] = 0x85;
+    mac[2] = id;
+}
+
+static bool flagged_stale(int slot)
+{
+    mac_entry_t copy;
+    return mac_table_get_by_index(&table, (size_t)slot, &copy) == MAC_TABLE_OK &&
+           (copy.flags & MAC_ENTRY_FLAG_STALE);
+}
+
+int main(void)
+{
+    uint8_t a[MAC_ADDR_LEN], b[MAC_ADDR_LEN], c[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 8, 100, test_record_event));
+    CHECK(mac_table_set_stale_timeout(&table, 50));
+
+    make_mac(1, a);
+    make_mac(2, b);
+    make_mac(3, c);
+    CHECK(mac_table_insert(&table, a) == MAC_TABLE_INSERTED);
+    CHECK(mac_table_insert(&table, b) == MAC_TABLE_INSERTED);
+    CHECK(mac_table_insert(&table, c) == MAC_TABLE_INSERTED);
+    int slot_a = test_events[0].slot;
+
+    // The TTL moves entries to the stale stage, reported once, still resolvable
+    host_advance(99);
+    CHECK(test_count_events(MAC_TABLE_STALE) == 0);
+    host_advance(1);
+    CHECK(test_count_events(MAC_TABLE_STALE) == 3);
+    CHECK(test_count_events(MAC_TABLE_TIMEOUT) == 0);
+    CHECK(table.stats->stale_entries == 3);
+    CHECK(table.stats->active_entries == 3);
+    CHECK(flagged_stale(slot_a));
+    CHECK(mac_table_exists(&table, a) == MAC_TABLE_OK);
+
+    // A refresh and a touch revive without an insert event
+    size_t inserted = test_count_events(MAC_TABLE_INSERTED);
+    host_advance(10);
+    CHECK(mac_table_insert(&table, a) == MAC_TABLE_UPDATED);
+    CHECK(mac_table_touch(&table, b) == MAC_TABLE_UPDATED);
+    CHECK(test_count_events(MAC_TABLE_INSERTED) == inserted);
+    CHECK(table.stats->stale_entries == 1);
+    CHECK(!flagged_stale(slot_a));
+
+    // The stale period runs out for the entry left alone
+    host_advance(39);
+    CHECK(test_count_mac_events(c, MAC_TABLE_TIMEOUT) == 0);
+    host_advance(1);
+    CHECK(test_count_mac_events(c, MAC_TABLE_TIMEOUT) == 1);
+    CHECK(mac_table_exists(&table, c) == MAC_TABLE_NOT_FOUND);
+    CHECK(table.stats->stale_entries == 0);
+    CHECK(table.stats->active_entries == 2);
+
+    // Revived entries got a full TTL from the refresh and go stale again
+    host_advance(59);
+    CHECK(test_count_mac_events(a, MAC_TABLE_STALE) == 1);
+    host_advance(1);
+    CHECK(test_count_mac_events(a, MAC_TABLE_STALE) == 2);
+    CHECK(test_count_mac_events(b, MAC_TABLE_STALE) == 2);
+    CHECK(table.stats->stale_entries == 2);
+
+    // Deleting a stale entry keeps the count right
+    CHECK(mac_table_delete(&table, b) == MAC_TABLE_DELETED);
+    CHECK(table.stats->stale_entries == 1);
+
+    // Warnings precede the final removal, not the move to stale
+    CHECK(mac_table_set_expiry_warning(&table, 10));
+    CHECK(mac_table_insert(&table, c) == MAC_TABLE_INSERTED);
+    host_advance(100);
+    CHECK(test_count_mac_events(c, MAC_TABLE_STALE) == 2);
+    CHECK(test_count_mac_events(c, MAC_TABLE_EXPIRING) == 0);
+    host_advance(40);
+    CHECK(test_count_mac_events(c, MAC_TABLE_EXPIRING) == 1);
+    CHECK(test_count_mac_events(c, MAC_TABLE_TIMEOUT) == 1);
+    host_advance(10);
+    CHECK(test_count_mac_events(c, MAC_TABLE_TIMEOUT) == 2);
+
+    // Without a stale stage entries are removed at the TTL
+    CHECK(mac_table_set_stale_timeout(&table, 0));
+    CHECK(mac_table_insert(&table, b) == MAC_TABLE_INSERTED);
+    host_advance(100);
+    CHECK(test_count_mac_events(b, MAC_TABLE_STALE) == 2);
+    CHECK(test_count_mac_events(b, MAC_TABLE_TIMEOUT) == 1);
+
+    return test_report("test_stale");
+}
@@ -0,0 +1,73 @@
+/* Host tests for per-MAC TTL jitter: lifetimes stay within the configured
+ * spread, are spread out, and are the same every time for a given MAC. */
+
+#include "mac_table.h"
+#include "test_util.h"
+
+#define ENTRIES 500
+#define TTL 100
+
+static mac_entry_t entries[512];
+static mac_table_t table;
+
+// Lifetime the table gives a MAC inserted now
+static time_t lifetime_of(const uint8_t *mac)
+{
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    for (size_t i = 0; i < table.size; i++) {
+        mac_entry_t entry;
+        uint8_t stored[MAC_ADDR_LEN];
+        if (mac_table_get_by_index(&table, i, &entry) == MAC_TABLE_OK) {
+            mac_table_entry_mac(&table, &entry, stored);
+            if (memcmp(stored, mac, MAC_ADDR_LEN) == 0) {
+                return entry.timeout_duration - host_now;
+            }
+        }
+    }
+    CHECK(false);
+    return 0;
+}
+
+int main(void)
+{
+    CHECK(mac_table_init(&table, entries, 512, TTL, NULL));
+    CHECK(!mac_table_set_ttl_jitter(&table, 101));
+
+    uint8_t mac[MAC_ADDR_LEN] = {0x00, 0x24, 0x01};
+    CHECK(lifetime_of(mac) == TTL);
+    CHECK(mac_table_delete(&table, mac) == MAC_TABLE_DELETED);
+
+    CHECK(mac_table_set_ttl_jitter(&table, 20));
+    static bool seen[2 * TTL];
+    size_t distinct = 0;
+    uint8_t macs[ENTRIES][MAC_ADDR_LEN];
+    time_t lifetimes[ENTRIES];
+    for (size_t i = 0; i < ENTRIES; i++) {
+        test_random_key(macs[i], MAC_ADDR_LEN);
+        lifetimes[i] = lifetime_of(macs[i]);
+        CHECK(lifetimes[i] >= TTL - TTL / 5 && lifetimes[i] <= TTL + TTL / 5);
+        if (lifetimes[i] > 0 && lifetimes[i] < 2 * TTL && !seen[lifetimes[i]]) {
+            seen[lifetimes[i]] = true;
+            distinct++;
+        }
+    }
+    CHECK(distinct > 30); // 41 possible values
+
+    // Deterministic: the same MAC gets the same lifetime when it comes back
+    host_advance(7);
+    for (size_t i = 0; i < ENTRIES; i += 25) {
+        CHECK(mac_table_delete(&table, macs[i]) == MAC_TABLE_DELETED);
+        CHECK(lifetime_of(macs[i]) == lifetimes[i]);
+    }
+
+    // Expiry is spread over the jitter window rather than one instant
+    size_t active = table.stats->active_entries;
+    host_advance(TTL - TTL / 5 - 8);
+    CHECK(table.stats->active_entries == active);
+    host_advance(TTL / 5);
+    CHECK(table.stats->active_entries > 0 && table.stats->active_entries < active);
+    host_advance(TTL / 5 + 8);
+    CHECK(table.stats->active_entries == 0);
+
+    return test_report("test_ttl_jitter");
+}
@@ -0,0 +1,44 @@
+/* Tiny assertion helpers shared by the host tests. */
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+static int test_failures;
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,         \
+                    __LINE__, #cond);                                      \
+            test_failures++;                                               \
+        }                                                                  \
+    } while (0)
+
+// Deterministic xorshift32 stream, so failures reproduce
+static uint32_t test_rand_state = 0x2545F491u;
+
+static inline uint32_t test_rand(void)
+{
+    uint32_t x = test_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return test_rand_state = x;
+}
+
+static inline void test_random_key(uint8_t *key, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        key[i] = (uint8_t)test_rand();
+    }
+}
+
+static inline int test_report(const char *name)
+{
+    printf("%s: %s\n", name, test_failures ? "FAILED" : "ok");
+    return test_failures ? 1 : 0;
+}
+
+#endif // TEST_UTIL_H
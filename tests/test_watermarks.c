@@ -0,0 +1,79 @@
+/* Host tests for occupancy watermarks: one event per crossing, with
+ * hysteresis between the high and low marks, carrying the MAC that crossed. */
+
+#include "mac_table.h"
+#include "test_events.h"
+#include "test_util.h"
+
+static mac_entry_t entries[10];
+static mac_table_t table;
+
+static void make_mac(uint8_t id, uint8_t *mac)
+{
+    memset(mac, 0, MAC_ADDR_LEN);
+    mac[1] = 0x82;
+    mac[2] = id;
+}
+
+static const test_event_t *last_event(void)
+{
+    return test_event_count > 0 ? &test_events[test_event_count - 1] : NULL;
+}
+
+int main(void)
+{
+    uint8_t mac[MAC_ADDR_LEN];
+    CHECK(mac_table_init(&table, entries, 10, 100, test_record_event));
+    CHECK(!mac_table_set_watermarks(&table, 80, 80));
+    CHECK(!mac_table_set_watermarks(&table, 101, 50));
+    CHECK(mac_table_set_watermarks(&table, 80, 50));
+
+    for (uint8_t id = 1; id <= 7; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    CHECK(test_count_events(MAC_TABLE_HIGH_WATERMARK) == 0);
+
+    make_mac(8, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    CHECK(test_count_events(MAC_TABLE_HIGH_WATERMARK) == 1);
+    CHECK(last_event()->status == MAC_TABLE_HIGH_WATERMARK && last_event()->slot == -1);
+    CHECK(memcmp(last_event()->mac, mac, MAC_ADDR_LEN) == 0);
+
+    make_mac(9, mac);
+    CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    CHECK(test_count_events(MAC_TABLE_HIGH_WATERMARK) == 1); // Edge-triggered
+
+    // Between the marks nothing fires; reaching the low mark does
+    for (uint8_t id = 9; id >= 7; id--) {
+        make_mac(id, mac);
+        CHECK(mac_table_delete(&table, mac) == MAC_TABLE_DELETED);
+    }
+    CHECK(test_count_events(MAC_TABLE_LOW_WATERMARK) == 0);
+    make_mac(6, mac);
+    CHECK(mac_table_delete(&table, mac) == MAC_TABLE_DELETED);
+    CHECK(test_count_events(MAC_TABLE_LOW_WATERMARK) == 1);
+    CHECK(memcmp(last_event()->mac, mac, MAC_ADDR_LEN) == 0);
+
+    // Expiry drains the table through the low mark as well
+    for (uint8_t id = 6; id <= 8; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    CHECK(test_count_events(MAC_TABLE_HIGH_WATERMARK) == 2);
+    host_advance(100);
+    CHECK(table.stats->active_entries == 0);
+    CHECK(test_count_events(MAC_TABLE_LOW_WATERMARK) == 2);
+
+    // Configuring aging re-evaluates its level without raising watermarks
+    for (uint8_t id = 1; id <= 9; id++) {
+        make_mac(id, mac);
+        CHECK(mac_table_insert(&table, mac) == MAC_TABLE_INSERTED);
+    }
+    size_t events = test_event_count;
+    const mac_table_aging_level_t levels[] = {{50, 50}};
+    CHECK(mac_table_set_adaptive_aging(&table, levels, 1));
+    CHECK(test_event_count == events);
+
+    return test_report("test_watermarks");
+}
@@ -0,0 +1,278 @@
+/*
+ * mac_mph_gen - emit a MAC allowlist as a constant minimal perfect hash table.
+ *
+ * Host tool; build and run it on the development machine:
+ *
+ *   cc -O2 -Isrc -o mac_mph_gen tools/mac_mph_gen.c
+ *   ./mac_mph_gen known_devices known_devices.txt > src/known_devices.c
+ *
+ * The input holds one MAC per line ("00:1A:2B:3C:4D:5E" or with '-'); blank
+ * lines and lines starting with '#' are ignored, duplicates are merged. The
+ * output defines `const mac_mph_t <name>` for `mac_mph_exists()`; declare it
+ * with `extern const mac_mph_t <name>;` where it is used.
+ *
+ * For other key widths build the tool with the same -DMAC_ADDR_LEN as the
+ * firmware.
+ *
+ * Construction is hash-and-displace (CHD): keys are hashed into buckets of
+ * about four, and buckets are placed largest first by searching for a
+ * displacement pair that sends all their keys to free slots.
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mac_mph_hash.h"
+
+#define KEYS_PER_BUCKET 4
+#define MAX_SEEDS 1000
+#define MAX_PAIR_TRIES (1u << 22)
+
+typedef struct {
+    uint8_t mac[MAC_ADDR_LEN];
+} mac_key_t;
+
+typedef struct {
+    size_t first; // Index into the bucket-ordered key list
+    size_t count; // Keys in this bucket
+    size_t id;    // Bucket number
+} bucket_t;
+
+static bool parse_mac(const char *str, uint8_t *mac)
+{
+    for (int i = 0; i < MAC_ADDR_LEN; i++) {
+        unsigned int byte;
+        if (!isxdigit((unsigned char)str[0]) || !isxdigit((unsigned char)str[1]) || sscanf(str, "%2x", &byte) != 1) {
+            return false;
+        }
+        mac[i] = (uint8_t)byte;
+        str += 2;
+        if (i < MAC_ADDR_LEN - 1) {
+            if (*str != ':' && *str != '-') {
+                return false;
+            }
+            str++;
+        }
+    }
+    while (isspace((unsigned char)*str)) {
+        str++;
+    }
+    return *str == '\0';
+}
+
+static int compare_keys(const void *a, const void *b)
+{
+    return memcmp(a, b, MAC_ADDR_LEN);
+}
+
+static int compare_buckets(const void *a, const void *b)
+{
+    const bucket_t *x = a;
+    const bucket_t *y = b;
+    return (x->count < y->count) - (x->count > y->count);
+}
+
+static size_t read_keys(FILE *in, mac_key_t **out)
+{
+    size_t count = 0;
+    size_t capacity = 64;
+    mac_key_t *keys = malloc(capacity * sizeof(mac_key_t));
+    char line[256];
+    size_t line_no = 0;
+
+    while (keys && fgets(line, sizeof(line), in)) {
+        line_no++;
+        char *start = line;
+        while (isspace((unsigned char)*start)) {
+            start++;
+        }
+        if (*start == '\0' || *start == '#') {
+            continue;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            mac_key_t *grown = realloc(keys, capacity * sizeof(mac_key_t));
+            if (!grown) {
+                free(keys);
+                keys = NULL;
+                break;
+            }
+            keys = grown;
+        }
+        if (!parse_mac(start, keys[count].mac)) {
+            fprintf(stderr, "line %zu: not a MAC address: %s", line_no, start);
+            exit(1);
+        }
+        count++;
+    }
+    if (!keys) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+
+    // Merge duplicates; a perfect hash cannot hold the same key twice
+    qsort(keys, count, sizeof(mac_key_t), compare_keys);
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique == 0 || memcmp(keys[unique - 1].mac, keys[i].mac, MAC_ADDR_LEN) != 0) {
+            keys[unique++] = keys[i];
+        }
+    }
+    *out = keys;
+    return unique;
+}
+
+// Try one seed; fills displacements and slot_of_key on success
+static bool build(const mac_key_t *keys, size_t n, size_t nbuckets, uint32_t seed, uint32_t *displacements,
+                  size_t *slot_of_key)
+{
+    uint64_t *hashes = malloc(n * sizeof(uint64_t));
+    size_t *order = malloc(n * sizeof(size_t));
+    bucket_t *buckets = calloc(nbuckets, sizeof(bucket_t));
+    bool *taken = calloc(n, sizeof(bool));
+    size_t *trial = malloc(KEYS_PER_BUCKET * 8 * sizeof(size_t));
+    bool ok = hashes && order && buckets && taken && trial;
+
+    if (ok) {
+        // Group keys by bucket
+        for (size_t i = 0; i < n; i++) {
+            hashes[i] = mac_mph_hash(keys[i].mac, seed);
+            buckets[(uint32_t)(hashes[i] >> 32) % nbuckets].count++;
+        }
+        size_t offset = 0;
+        for (size_t b = 0; b < nbuckets; b++) {
+            buckets[b].id = b;
+            buckets[b].first = offset;
+            offset += buckets[b].count;
+            buckets[b].count = 0;
+        }
+        for (size_t i = 0; i < n; i++) {
+            bucket_t *bucket = &buckets[(uint32_t)(hashes[i] >> 32) % nbuckets];
+            order[bucket->first + bucket->count++] = i;
+        }
+        qsort(buckets, nbuckets, sizeof(bucket_t), compare_buckets);
+        ok = buckets[0].count <= KEYS_PER_BUCKET * 8;
+    }
+
+    for (size_t b = 0; ok && b < nbuckets && buckets[b].count > 0; b++) {
+        const bucket_t *bucket = &buckets[b];
+        bool placed = false;
+        uint64_t pairs = (uint64_t)n * n;
+        if (pairs > MAX_PAIR_TRIES) {
+            pairs = MAX_PAIR_TRIES;
+        }
+
+        for (uint64_t d = 0; d < pairs && !placed; d++) {
+            uint32_t displacement = (uint32_t)(d / n) << 16 | (uint32_t)(d % n);
+            size_t k;
+            for (k = 0; k < bucket->count; k++) {
+                size_t slot = mac_mph_slot(hashes[order[bucket->first + k]], displacement, n);
+                bool clash = taken[slot];
+                for (size_t j = 0; j < k && !clash; j++) {
+                    clash = trial[j] == slot;
+                }
+                if (clash) {
+                    break;
+                }
+                trial[k] = slot;
+            }
+            if (k == bucket->count) {
+                for (k = 0; k < bucket->count; k++) {
+                    taken[trial[k]] = true;
+                    slot_of_key[order[bucket->first + k]] = trial[k];
+                }
+                displacements[bucket->id] = displacement;
+                placed = true;
+            }
+        }
+        ok = placed;
+    }
+
+    free(hashes);
+    free(order);
+    free(buckets);
+    free(taken);
+    free(trial);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "usage: %s <name> [input-file] > output.c\n", argv[0]);
+        return 2;
+    }
+    const char *name = argv[1];
+    FILE *in = argc == 3 ? fopen(argv[2], "r") : stdin;
+    if (!in) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    mac_key_t *keys;
+    size_t n = read_keys(in, &keys);
+    if (in != stdin) {
+        fclose(in);
+    }
+    if (n == 0 || n > 0xFFFF) {
+        fprintf(stderr, "need 1 to 65535 distinct MAC addresses, got %zu\n", n);
+        return 1;
+    }
+
+    size_t nbuckets = (n + KEYS_PER_BUCKET - 1) / KEYS_PER_BUCKET;
+    uint32_t *displacements = calloc(nbuckets, sizeof(uint32_t));
+    size_t *slot_of_key = malloc(n * sizeof(size_t));
+    mac_key_t *by_slot = malloc(n * sizeof(mac_key_t));
+    if (!displacements || !slot_of_key || !by_slot) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    uint32_t seed;
+    for (seed = 0; seed < MAX_SEEDS; seed++) {
+        if (build(keys, n, nbuckets, seed, displacements, slot_of_key)) {
+            break;
+        }
+        memset(displacements, 0, nbuckets * sizeof(uint32_t));
+    }
+    if (seed == MAX_SEEDS) {
+        fprintf(stderr, "no perfect hash found after %d seeds\n", MAX_SEEDS);
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        by_slot[slot_of_key[i]] = keys[i];
+    }
+
+    printf("// Generated by tools/mac_mph_gen.c from %zu MAC addresses. Do not edit.\n\n", n);
+    printf("#include \"mac_mph.h\"\n\n");
+    printf("static const uint32_t %s_displacements[%zu] = {", name, nbuckets);
+    for (size_t b = 0; b < nbuckets; b++) {
+        printf("%s0x%08X,", b % 6 ? " " : "\n    ", (unsigned)displacements[b]);
+    }
+    printf("\n};\n\n");
+    printf("static const uint8_t %s_keys[%zu][MAC_ADDR_LEN] = {\n", name, n);
+    for (size_t i = 0; i < n; i++) {
+        printf("    {");
+        for (size_t j = 0; j < MAC_ADDR_LEN; j++) {
+            printf("%s0x%02X", j ? ", " : "", by_slot[i].mac[j]);
+        }
+        printf("},\n");
+    }
+    printf("};\n\n");
+    printf("const mac_mph_t %s = {\n", name);
+    printf("    .seed = %uu,\n", (unsigned)seed);
+    printf("    .key_count = %zu,\n", n);
+    printf("    .bucket_count = %zu,\n", nbuckets);
+    printf("    .displacements = %s_displacements,\n", name);
+    printf("    .keys = %s_keys,\n", name);
+    printf("};\n");
+
+    free(keys);
+    free(displacements);
+    free(slot_of_key);
+    free(by_slot);
+    return 0;
+}